@@ -0,0 +1,170 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "../TrafficJamLogic/AStar.h"
+#include "../TrafficJamLogic/BatchSolver.h"
+#include "../TrafficJamLogic/Board.h"
+#include "../TrafficJamLogic/CorpusReader.h"
+#include "../TrafficJamLogic/EngineSelector.h"
+#include "../TrafficJamLogic/Portfolio.h"
+#include "../TrafficJamLogic/ResultWriter.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef TRAFFIC_JAM_CORPUS
+#define TRAFFIC_JAM_CORPUS "corpus.txt"
+#endif
+
+namespace {
+/// <summary>
+/// Parse a puzzle written as one character per cell, row by row.
+/// 'o' or '.' is an empty cell, 'A' is the main car and every other letter is
+/// another car.
+/// </summary>
+Board parseBoard(const std::string &cells) {
+  std::vector<int> game_board{};
+  game_board.reserve(cells.size());
+
+  for (const auto &c : cells) {
+    game_board.emplace_back(c == 'o' || c == '.' ? 0 : c - 'A' + 1);
+  }
+
+  return Board{game_board};
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  std::string corpus_path = argc > 1 ? argv[1] : TRAFFIC_JAM_CORPUS;
+  int repeat = argc > 2 ? std::stoi(argv[2]) : 1;
+
+  // Remaining arguments enable search options
+  AStar::Options options{};
+  bool anytime = false;
+  bool portfolio = false;
+  bool batch = false;
+  std::unique_ptr<EngineSelector> selector{};
+  std::unique_ptr<ResultWriter> writer{};
+  for (auto i = 3; i < argc; ++i) {
+    std::string flag{argv[i]};
+    if (flag == "prune") {
+      options.generation.prune_transpositions = true;
+    } else if (flag == "slide") {
+      options.generation.slide = true;
+      options.cost = AStar::Options::Cost::Slides;
+    } else if (flag == "lazy") {
+      options.lazy_heuristic = true;
+    } else if (flag == "anytime") {
+      anytime = true;
+    } else if (flag == "portfolio") {
+      portfolio = true;
+    } else if (flag == "batch") {
+      batch = true;
+    } else if (flag.rfind("select=", 0) == 0) {
+      selector = std::make_unique<EngineSelector>(
+          EngineSelector::load(flag.substr(7)));
+    } else if (flag.rfind("out=", 0) == 0) {
+      const auto path = flag.substr(4);
+      writer = std::make_unique<ResultWriter>(path,
+                                              ResultWriter::getFormat(path));
+    } else if (flag.rfind("weight=", 0) == 0) {
+      options.weight = std::stod(flag.substr(7));
+    } else {
+      std::cerr << "Unknown option " << flag << '\n';
+      return 1;
+    }
+  }
+
+  // The whole corpus is parsed in parallel and solved as one batch
+  if (batch) {
+    BatchSolver solver{};
+    auto t1 = std::chrono::high_resolution_clock::now();
+    const auto count = CorpusReader::load(corpus_path, solver);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    const auto solutions = solver.solve();
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    if (writer != nullptr) {
+      for (std::size_t i = 0; i < solutions.size(); ++i) {
+        writer->write(static_cast<std::uint32_t>(i), solutions[i]);
+      }
+      writer->close();
+    }
+    std::cout << "Parsed " << count << " puzzles in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " ms, solved in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2)
+                     .count()
+              << " ms" << '\n';
+    return 0;
+  }
+
+  std::ifstream corpus{corpus_path};
+  if (!corpus) {
+    std::cerr << "Cannot open " << corpus_path << '\n';
+    return 1;
+  }
+
+  // Each line holds the puzzle and its optimal number of moves
+  std::vector<std::pair<Board, int>> puzzles{};
+  std::string line;
+  while (std::getline(corpus, line)) {
+    std::istringstream fields{line};
+    std::string cells;
+    int optimal = 0;
+    if (fields >> cells >> optimal) {
+      puzzles.emplace_back(parseBoard(cells), optimal);
+    }
+  }
+
+  const auto engines = Portfolio::getDefaultEngines();
+  std::chrono::nanoseconds total{0};
+
+  for (std::size_t i = 0; i < puzzles.size(); ++i) {
+    std::vector<std::shared_ptr<Board>> path{};
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (auto r = 0; r < repeat; ++r) {
+      const Board &board = puzzles[i].first;
+      if (selector != nullptr) {
+        path = selector->solve(board);
+      } else if (portfolio) {
+        path = Portfolio::solve(board, engines).path;
+      } else if (anytime) {
+        path = AStar::anytimeSearch(board, options);
+      } else {
+        path = AStar::search(board, options);
+      }
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    total += t2 - t1;
+
+    const std::size_t moves = path.size() - 1;
+    if (writer != nullptr) {
+      writer->write(static_cast<std::uint32_t>(i), path);
+    }
+
+    std::cout << "Puzzle " << i << ": " << moves << " moves (optimal "
+              << puzzles[i].second << ") in "
+              << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+                         .count() /
+                     repeat
+              << " us" << '\n';
+  }
+
+  if (writer != nullptr) {
+    writer->close();
+  }
+
+  std::cout << "Total: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(total)
+                   .count()
+            << " ms" << '\n';
+}
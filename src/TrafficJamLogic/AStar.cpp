@@ -1,112 +1,616 @@
-/**
- * Copyright 2019 Martin Pham
- */
-
-#include "AStar.h"
-
-std::vector<std::shared_ptr<Board>> AStar::reconstructPath(
-    const std::unordered_map<std::shared_ptr<Node>, std::shared_ptr<Node>>
-        &came_from,
-    const std::shared_ptr<Node> &current) {
-  // Using vector of shared_ptr is 20% faster
-  std::vector<std::shared_ptr<Board>> path{current->board};
-
-  auto curr = current;
-
-  while (curr->parent != nullptr) {
-    auto parent = curr->parent;
-    path.emplace(path.begin(), parent->board);
-    curr = parent;
-  }
-
-  return path;
-}
-
-int AStar::calculateHValue(const Node &current) {
-  // Heuristic value is the number of cars in front of the main car
-  int h = 0;
-
-  if (!current.board->solved()) {
-    auto main_car = current.board->getMainCar();
-    int main_id = main_car.getId();
-    int main_row = main_car.getPosRow();
-    int main_col = main_car.getPosCol();
-    int main_length = main_car.getLength();
-
-    for (auto i = main_col + main_length; i < current.board->getBoardSize();
-         ++i) {
-      if (current.board->getGameBoardAt(main_row, i) != main_id &&
-          current.board->getGameBoardAt(main_row, i) != 0) {
-        ++h;
-      }
-    }
-
-    return 1 + h;
-  }
-
-  return h;
-}
-
-std::vector<std::shared_ptr<Board>> AStar::search(const Board &board) {
-  // Using shared_ptr for Node objects is 50% faster
-  std::unordered_map<std::shared_ptr<Node>, std::shared_ptr<Node>> came_from{};
-  std::unordered_set<std::shared_ptr<Node>> closed_list{};
-
-  // Comparing only the f_value of each Node for the priority queue
-  auto node_priority_cmp = [](const std::shared_ptr<Node> &lhs,
-                              const std::shared_ptr<Node> &rhs) {
-    return lhs->f_value < rhs->f_value;
-  };
-  std::multiset<std::shared_ptr<Node>, decltype(node_priority_cmp)> open_list{
-      node_priority_cmp};
-
-  // Comparing only the board of each Node to check if the node is visited
-  auto node_cmp = [](const std::shared_ptr<Node> &lhs,
-                     const std::shared_ptr<Node> &rhs) {
-    return *lhs->board < *rhs->board;
-  };
-  std::set<std::shared_ptr<Node>, decltype(node_cmp)> visited_list{node_cmp};
-
-  Node start{board};
-  start.g_value = 0;
-  start.f_value = calculateHValue(start) + start.g_value;
-
-  open_list.emplace(std::make_shared<Node>(start));
-
-  while (!open_list.empty()) {
-    auto current_it = open_list.begin();
-    auto current = *current_it;
-
-    if (current->board->solved()) {
-      return reconstructPath(came_from, current);
-    }
-
-    open_list.erase(current_it);
-    closed_list.emplace(current);
-
-    for (auto &n : current->getNeighbours()) {
-      if (closed_list.count(n)) {
-        continue;
-      }
-
-      // Each move counts as 1
-      int g_score = current->g_value + 1;
-
-      bool visited = visited_list.count(n);
-
-      if (!visited || g_score < n->g_value) {
-        came_from.emplace(n, current);
-        n->parent = std::make_shared<Node>(*current);
-        n->g_value = g_score;
-        n->f_value = calculateHValue(*n);
-
-        if (!visited) {
-          open_list.emplace(n);
-          visited_list.emplace(n);
-        }
-      }
-    }
-  }
-
-  return {};
-}
\ No newline at end of file
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "AStar.h"
+
+#include "Layout.h"
+#include "StateTable.h"
+
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+std::vector<std::shared_ptr<Board>> AStar::reconstructPath(
+    const std::shared_ptr<const Node> &current) {
+  // Using vector of shared_ptr is 20% faster
+  std::vector<std::shared_ptr<Board>> path{current->board};
+
+  // Collect the boards from the goal back to the start and reverse once
+  // instead of inserting every board at the front
+  for (auto curr = current->parent; curr != nullptr; curr = curr->parent) {
+    path.emplace_back(curr->board);
+  }
+  std::reverse(path.begin(), path.end());
+
+  return path;
+}
+
+std::vector<Move> AStar::getMoves(
+    const std::vector<std::shared_ptr<Board>> &path) {
+  std::vector<Move> moves{};
+
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    moves.emplace_back(path[i - 1]->getMoveTo(*path[i]));
+  }
+
+  return moves;
+}
+
+int AStar::calculateHValue(const Node &current) {
+  return calculateHValue(*current.board);
+}
+
+int AStar::calculateHValue(const Board &board) {
+  // Heuristic value is the number of cars in front of the main car
+  int h = 0;
+
+  if (!board.solved()) {
+    const Car &main_car = board.getMainCar();
+    int main_id = main_car.getId();
+    int main_row = main_car.getPosRow();
+    int main_col = main_car.getPosCol();
+    int main_length = main_car.getLength();
+
+    for (auto i = main_col + main_length; i < board.getBoardSize(); ++i) {
+      if (board.getGameBoardAt(main_row, i) != main_id &&
+          board.getGameBoardAt(main_row, i) != 0) {
+        ++h;
+      }
+    }
+
+    return 1 + h;
+  }
+
+  return h;
+}
+
+int AStar::updateHValue(const Node &current) {
+  if (current.parent == nullptr || !current.parent->h_evaluated) {
+    return calculateHValue(*current.board);
+  }
+  return updateHValue(*current.board, current.parent->h_value);
+}
+
+int AStar::updateHValue(const Board &board, int parent_h) {
+  const Move &move = board.getLastMove();
+  if (move.car_id == 0) {
+    return calculateHValue(board);
+  }
+  if (board.solved()) {
+    return 0;
+  }
+  // The main car moved off the goal, the heuristic gains its +1 term
+  if (parent_h == 0) {
+    return calculateHValue(board);
+  }
+
+  // Only a vertical car ahead of the main car can enter or leave the cells
+  // the heuristic counts. Moving the main car, or any horizontal car, keeps
+  // the number of occupied cells ahead of the main car
+  const Car &main_car = board.getMainCar();
+  const Car &car = board.getCar(move.car_id);
+  if (car.getDirection() == Car::Direction::Horizontal ||
+      car.getPosCol() < main_car.getPosCol() + main_car.getLength()) {
+    return parent_h;
+  }
+
+  // Rows covered by the car before and after the move, the main car's row is
+  // blocked when its bit is set
+  const uint64_t cells = (uint64_t{1} << car.getLength()) - 1;
+  const int top = car.getPosRow() + 1 - car.getLength();
+  const uint64_t row = uint64_t{1} << main_car.getPosRow();
+  const int before = (cells << (top - move.delta) & row) != 0;
+  const int after = (cells << top & row) != 0;
+
+  return parent_h + after - before;
+}
+
+void AStar::calculateHValues(const Layout &layout, const std::uint64_t *states,
+                             std::size_t count, int *h_values) {
+  // The cells ahead of the main car at position p are the cells of its row
+  // from column p + length on. A solved state has none of them and is the
+  // only state whose main car is at the end of its row
+  const int size = layout.getBoardSize();
+  const int main = layout.getMainIndex();
+  const int length = layout.getLength(main);
+  const int row = layout.getLane(main);
+  const std::uint64_t row_mask = ((std::uint64_t{1} << size) - 1)
+                                 << (row * size);
+  const int first = row * size + length;
+  const int limit = size - length;
+  std::size_t k = 0;
+
+#if defined(__AVX2__)
+  const int cars = layout.getCarCount();
+  std::uint64_t bases[Layout::kMaxCars];
+  std::uint64_t strides[Layout::kMaxCars];
+  for (auto i = 0; i < cars; ++i) {
+    bases[i] = layout.getCarMask(i, 0);
+    strides[i] = layout.getDirection(i) == Car::Direction::Horizontal
+                     ? 1
+                     : static_cast<std::uint64_t>(size);
+  }
+
+  const __m256i nibble = _mm256_set1_epi64x(0xF);
+  const __m256i low_bits = _mm256_set1_epi8(0xF);
+  // Number of set bits of every nibble value
+  const __m256i counts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3,
+                                          2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                          1, 2, 2, 3, 2, 3, 3, 4);
+  alignas(32) std::uint64_t values[4];
+
+  for (; k + 4 <= count; k += 4) {
+    const __m256i state =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(states + k));
+    __m256i occupancy = _mm256_setzero_si256();
+    for (auto i = 0; i < cars; ++i) {
+      const __m256i position = _mm256_and_si256(
+          _mm256_srl_epi64(state, _mm_cvtsi32_si128(4 * i)), nibble);
+      const __m256i shift = _mm256_mul_epu32(
+          position, _mm256_set1_epi64x(static_cast<long long>(strides[i])));
+      occupancy = _mm256_or_si256(
+          occupancy,
+          _mm256_sllv_epi64(
+              _mm256_set1_epi64x(static_cast<long long>(bases[i])), shift));
+    }
+
+    const __m256i main_position = _mm256_and_si256(
+        _mm256_srl_epi64(state, _mm_cvtsi32_si128(4 * main)), nibble);
+    const __m256i ahead = _mm256_and_si256(
+        _mm256_sllv_epi64(
+            _mm256_set1_epi64x(-1),
+            _mm256_add_epi64(main_position, _mm256_set1_epi64x(first))),
+        _mm256_set1_epi64x(static_cast<long long>(row_mask)));
+    const __m256i blockers = _mm256_and_si256(occupancy, ahead);
+
+    // Count the bits of every byte from its two nibbles, then sum the bytes
+    // of every 64-bit lane
+    const __m256i bits = _mm256_add_epi8(
+        _mm256_shuffle_epi8(counts, _mm256_and_si256(blockers, low_bits)),
+        _mm256_shuffle_epi8(
+            counts, _mm256_and_si256(_mm256_srli_epi16(blockers, 4),
+                                     low_bits)));
+    const __m256i unsolved =
+        _mm256_cmpgt_epi64(_mm256_set1_epi64x(limit), main_position);
+    const __m256i h = _mm256_sub_epi64(
+        _mm256_sad_epu8(bits, _mm256_setzero_si256()), unsolved);
+
+    _mm256_store_si256(reinterpret_cast<__m256i *>(values), h);
+    for (auto lane = 0; lane < 4; ++lane) {
+      h_values[k + lane] = static_cast<int>(values[lane]);
+    }
+  }
+#endif
+
+  for (; k < count; ++k) {
+    const int position = Layout::getPosition(states[k], main);
+    const std::uint64_t ahead =
+        first + position < 64 ? ~std::uint64_t{0} << (first + position) &
+                                    row_mask
+                              : 0;
+    h_values[k] =
+        static_cast<int>(
+            std::bitset<64>(layout.getOccupancy(states[k]) & ahead).count()) +
+        (position < limit ? 1 : 0);
+  }
+}
+
+namespace {
+/// <summary>
+/// An entry of the open list. Entries are never removed when a state is
+/// reached by a cheaper path, an entry whose g value no longer matches the
+/// state's is skipped when popped.
+/// </summary>
+struct OpenEntry {
+  double f_value;
+  int g_value;
+  std::uint32_t index;
+
+  // Lowest f value first, deeper states first among equal f values
+  bool operator<(const OpenEntry &other) const noexcept {
+    return this->f_value != other.f_value ? this->f_value > other.f_value
+                                          : this->g_value < other.g_value;
+  }
+};
+
+/// <summary>
+/// The states reached by a search: a StateTable of packed states with the
+/// board and heuristic value of each state.
+/// </summary>
+class StateSpace {
+ public:
+  StateSpace() = default;
+
+  explicit StateSpace(const Board &board) { this->reset(board); }
+
+  /// <summary>
+  /// Forget every state and start a new search from a board, keeping the
+  /// memory of the previous search.
+  /// </summary>
+  void reset(const Board &board) {
+    // States are packed into 64-bit keys. Boards a Layout cannot pack get
+    // sequential keys from an ordered map instead
+    this->layout_.reset();
+    try {
+      this->layout_ = std::make_unique<Layout>(board);
+    } catch (const std::invalid_argument &) {
+    }
+    this->fallback_keys_.clear();
+
+    this->table.clear();
+    this->boards.clear();
+    this->h_values.clear();
+    this->open_list.clear();
+
+    this->table.insert(this->getKey(board));
+    // The start is the root of the search even if it was produced by a
+    // move, pruning must not treat that move as the one leading to it
+    this->boards.emplace_back(std::make_shared<Board>(board));
+    this->boards.back()->clearLastMove();
+    this->h_values.emplace_back(AStar::calculateHValue(board));
+  }
+
+  /// <summary>
+  /// Rebuild the path from the start to a state from the parent indices.
+  /// </summary>
+  std::vector<std::shared_ptr<Board>> getPath(std::uint32_t index) const {
+    std::vector<std::shared_ptr<Board>> path{};
+    for (; index != StateTable::kNone; index = this->table.getParent(index)) {
+      path.emplace_back(this->boards[index]);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+  /// <summary>
+  /// Evaluate the heuristic of a state if it has not been evaluated yet.
+  /// </summary>
+  int evaluate(std::uint32_t index) {
+    if (this->h_values[index] < 0) {
+      const auto parent = this->table.getParent(index);
+      this->h_values[index] =
+          AStar::updateHValue(*this->boards[index], this->h_values[parent]);
+    }
+    return this->h_values[index];
+  }
+
+  /// <summary>
+  /// Generate the successors of a state and record every one reached by a
+  /// cheaper path than before. visit is called with the index of each of
+  /// them.
+  /// </summary>
+  template <class Visit>
+  void expand(std::uint32_t index, const AStar::Options &options,
+              Visit visit) {
+    // Hash every successor and prefetch its bucket before probing any
+    this->states_ = this->boards[index]->getPossibleStates(options.generation);
+    this->keys_.clear();
+    for (const auto &s : this->states_) {
+      this->keys_.emplace_back(this->getKey(s));
+      this->table.prefetch(this->keys_.back());
+    }
+
+    // Packed successors get their heuristic values in one batch, unless the
+    // heuristic is evaluated lazily
+    const bool batch = this->layout_ != nullptr && !options.lazy_heuristic;
+    if (batch) {
+      this->batch_h_values_.resize(this->keys_.size());
+      AStar::calculateHValues(*this->layout_, this->keys_.data(),
+                              this->keys_.size(),
+                              this->batch_h_values_.data());
+    }
+
+    const int g_value = this->table.getGValue(index);
+    for (std::size_t i = 0; i < this->states_.size(); ++i) {
+      // Each move counts as 1, or as the number of cells the car moved
+      const int delta = this->states_[i].getLastMove().delta;
+      int g_score = g_value + (options.cost == AStar::Options::Cost::Slides
+                                   ? 1
+                                   : std::abs(delta));
+
+      auto inserted = this->table.insert(this->keys_[i]);
+      const auto child = inserted.first;
+      if (inserted.second) {
+        this->boards.emplace_back(nullptr);
+        this->h_values.emplace_back(batch ? this->batch_h_values_[i] : -1);
+      } else if (g_score >= this->table.getGValue(child)) {
+        // Reopen a known state only when a cheaper path to it is found
+        continue;
+      }
+
+      // Keep the new board, it records the move from the new parent
+      this->boards[child] =
+          std::make_shared<Board>(std::move(this->states_[i]));
+      this->table.setGValue(child, g_score);
+      this->table.setParent(child, index);
+      visit(child);
+    }
+  }
+
+  StateTable table{};
+  // Boards and heuristic values by state index, -1 for an unevaluated
+  // heuristic
+  std::vector<std::shared_ptr<Board>> boards{};
+  std::vector<int> h_values{};
+  // Binary heap of open entries
+  std::vector<OpenEntry> open_list{};
+
+ private:
+  std::uint64_t getKey(const Board &board) {
+    if (this->layout_ != nullptr) {
+      return this->layout_->encode(board);
+    }
+    return this->fallback_keys_.emplace(board, this->fallback_keys_.size())
+        .first->second;
+  }
+
+  std::unique_ptr<Layout> layout_{};
+  std::map<Board, std::uint64_t> fallback_keys_{};
+  std::vector<Board> states_{};
+  std::vector<std::uint64_t> keys_{};
+  std::vector<int> batch_h_values_{};
+};
+}  // namespace
+
+struct AStar::Workspace::Impl {
+  StateSpace space;
+};
+
+AStar::Workspace::Workspace() : impl_{std::make_unique<Impl>()} {}
+
+AStar::Workspace::~Workspace() = default;
+
+std::vector<std::shared_ptr<Board>> AStar::search(const Board &board,
+                                                  const Options &options) {
+  Workspace workspace{};
+  return search(board, options, workspace);
+}
+
+namespace {
+/// <summary>
+/// Run an A* search from a board over a state space.
+/// </summary>
+/// <returns>The index of the state the solution ends at, kNone if there is
+/// no solution.</returns>
+std::uint32_t findSolution(const Board &board, const AStar::Options &options,
+                           StateSpace &space) {
+  space.reset(board);
+  std::vector<OpenEntry> &open_list = space.open_list;
+  auto push = [&open_list](const OpenEntry &entry) {
+    open_list.emplace_back(entry);
+    std::push_heap(open_list.begin(), open_list.end());
+  };
+
+  // Known costs to a solution by state index, -1 for none and -2 for a state
+  // not looked up yet
+  std::vector<int> known_costs{};
+  auto get_known_cost = [&options, &space, &known_costs](std::uint32_t index) {
+    if (!options.known_cost) {
+      return -1;
+    }
+    known_costs.resize(space.boards.size(), -2);
+    if (known_costs[index] == -2) {
+      known_costs[index] = options.known_cost(*space.boards[index]);
+    }
+    return known_costs[index];
+  };
+
+  const int start_cost = get_known_cost(0);
+  push(OpenEntry{start_cost >= 0
+                               ? start_cost
+                               : options.weight * space.h_values[0],
+                           0, 0});
+
+  std::size_t expanded = 0;
+  while (!open_list.empty()) {
+    if (++expanded % 256 == 0 && options.cancellation.isCancelled()) {
+      throw AStar::SearchCancelled{};
+    }
+
+    std::pop_heap(open_list.begin(), open_list.end());
+    const OpenEntry current = open_list.back();
+    open_list.pop_back();
+
+    if (current.g_value != space.table.getGValue(current.index)) {
+      continue;
+    }
+
+    // A lazily queued state gets its heuristic when it is first popped. If
+    // the heuristic raises its f value, the state goes back into the open list
+    if (space.h_values[current.index] < 0) {
+      const double f_value =
+          current.g_value + options.weight * space.evaluate(current.index);
+      if (f_value > current.f_value) {
+        push(OpenEntry{f_value, current.g_value, current.index});
+        continue;
+      }
+    }
+
+    // A state with a known cost is queued on its exact cost to a solution,
+    // the caller continues the path from it
+    if (space.boards[current.index]->solved() ||
+        get_known_cost(current.index) >= 0) {
+      return current.index;
+    }
+
+    const int current_h = space.h_values[current.index];
+    space.expand(current.index, options, [&](std::uint32_t index) {
+      const int g_value = space.table.getGValue(index);
+      const int known_cost = get_known_cost(index);
+      double f_value = 0;
+      if (known_cost >= 0) {
+        f_value = g_value + known_cost;
+      } else if (options.lazy_heuristic && space.h_values[index] < 0) {
+        // Queue on a bound from the parent's heuristic, the heuristic is
+        // consistent so it drops by at most the cost of the move
+        const int step = g_value - current.g_value;
+        f_value = g_value + options.weight * std::max(current_h - step, 0);
+      } else {
+        f_value = g_value + options.weight * space.evaluate(index);
+      }
+      push(OpenEntry{f_value, g_value, index});
+    });
+  }
+
+  return StateTable::kNone;
+}
+}  // namespace
+
+std::vector<std::shared_ptr<Board>> AStar::search(const Board &board,
+                                                  const Options &options,
+                                                  Workspace &workspace) {
+  StateSpace &space = workspace.impl_->space;
+  const auto goal = findSolution(board, options, space);
+  return goal == StateTable::kNone ? std::vector<std::shared_ptr<Board>>{}
+                                   : space.getPath(goal);
+}
+
+AStar::SolutionRange AStar::searchRange(const Board &board,
+                                        const Options &options,
+                                        Workspace &workspace) {
+  StateSpace &space = workspace.impl_->space;
+  const auto goal = findSolution(board, options, space);
+
+  SolutionRange range{};
+  range.workspace_ = &workspace;
+  if (goal == StateTable::kNone) {
+    return range;
+  }
+
+  // Turn the parent links of the path around in place so the path can be
+  // followed from the start, the search is over and no longer needs them
+  auto previous = StateTable::kNone;
+  for (auto index = goal; index != StateTable::kNone;) {
+    const auto parent = space.table.getParent(index);
+    space.table.setParent(index, previous);
+    previous = index;
+    index = parent;
+    ++range.size_;
+  }
+  range.start_ = previous;
+  return range;
+}
+
+const Board &AStar::SolutionRange::Iterator::operator*() const {
+  return *this->workspace_->impl_->space.boards[this->index_];
+}
+
+AStar::SolutionRange::Iterator &AStar::SolutionRange::Iterator::operator++() {
+  this->index_ = this->workspace_->impl_->space.table.getParent(this->index_);
+  return *this;
+}
+
+std::future<std::vector<std::shared_ptr<Board>>> AStar::searchAsync(
+    Board board, Options options) {
+  return std::async(std::launch::async,
+                    [board = std::move(board), options = std::move(options)] {
+                      return search(board, options);
+                    });
+}
+
+std::vector<std::shared_ptr<Board>> AStar::anytimeSearch(
+    const Board &board, const Options &options,
+    const AnytimeOptions &anytime_options, const SolutionCallback &callback) {
+  enum Status : char { None, Open, Closed, Inconsistent };
+
+  StateSpace space{board};
+  if (space.boards[0]->solved()) {
+    // The start is its own optimal solution
+    if (callback) {
+      callback(space.getPath(0), 1.0);
+    }
+    return space.getPath(0);
+  }
+  std::vector<char> status{Open};
+  std::priority_queue<OpenEntry> open_list{};
+  double weight = std::max(anytime_options.initial_weight, 1.0);
+  open_list.push(OpenEntry{weight * space.h_values[0], 0, 0});
+
+  auto best = StateTable::kNone;
+  int published = std::numeric_limits<int>::max();
+  std::size_t expanded = 0;
+
+  while (true) {
+    // Expand states while they could lead to a solution cheaper than the
+    // best one, states improved after they were expanded wait for the next
+    // iteration
+    while (!open_list.empty()) {
+      const OpenEntry current = open_list.top();
+      if (status[current.index] != Open ||
+          current.g_value != space.table.getGValue(current.index)) {
+        open_list.pop();
+        continue;
+      }
+      if (best != StateTable::kNone &&
+          current.f_value >= space.table.getGValue(best)) {
+        break;
+      }
+      open_list.pop();
+      status[current.index] = Closed;
+
+      if (++expanded % 1024 == 0 &&
+          (options.cancellation.isCancelled() ||
+           std::chrono::steady_clock::now() >= anytime_options.deadline)) {
+        return best == StateTable::kNone ? std::vector<std::shared_ptr<Board>>{}
+                                         : space.getPath(best);
+      }
+
+      space.expand(current.index, options, [&](std::uint32_t index) {
+        status.resize(space.boards.size(), None);
+        const int g_value = space.table.getGValue(index);
+        if (space.boards[index]->solved()) {
+          if (best == StateTable::kNone ||
+              g_value < space.table.getGValue(best)) {
+            best = index;
+          }
+        }
+
+        if (status[index] == Closed || status[index] == Inconsistent) {
+          status[index] = Inconsistent;
+        } else {
+          status[index] = Open;
+          open_list.push(OpenEntry{g_value + weight * space.evaluate(index),
+                                   g_value, index});
+        }
+      });
+    }
+
+    if (best == StateTable::kNone) {
+      // The open list ran out without reaching a solved state
+      return {};
+    }
+
+    // The best solution costs at most weight times the optimal cost
+    if (callback && space.table.getGValue(best) < published) {
+      published = space.table.getGValue(best);
+      callback(space.getPath(best), weight);
+    }
+    if (weight <= 1.0) {
+      return space.getPath(best);
+    }
+
+    // Lower the weight and queue the open and inconsistent states again,
+    // states expanded in this iteration stay expanded unless improved
+    weight = std::max(weight - anytime_options.weight_step, 1.0);
+    open_list = std::priority_queue<OpenEntry>{};
+    for (std::uint32_t i = 0; i < status.size(); ++i) {
+      if (status[i] == Open || status[i] == Inconsistent) {
+        status[i] = Open;
+        const int g_value = space.table.getGValue(i);
+        open_list.push(
+            OpenEntry{g_value + weight * space.evaluate(i), g_value, i});
+      } else {
+        status[i] = None;
+      }
+    }
+  }
+}
@@ -1,87 +1,390 @@
-/**
- * Copyright 2019 Martin Pham
- */
-
-#pragma once
-
-#include "Board.h"
-
-#include <algorithm>
-#include <memory>
-#include <queue>
-#include <set>
-#include <unordered_map>
-#include <unordered_set>
-#include <vector>
-
-namespace AStar {
-struct Node {
-  /// <summary>
-  /// A constructor for Node object.
-  /// </summary>
-  /// <param name="board">A Board object container positions of all
-  /// cars.</param>
-  explicit Node(const Board &board)
-      : board{std::make_shared<Board>(board)},
-        parent{nullptr},
-        g_value{0},
-        h_value{0},
-        f_value{0} {};
-
-  /// <summary>
-  /// Default constructor.
-  /// </summary>
-  Node() = default;
-
-  /// <summary>
-  /// Default destructor.
-  /// </summary>
-  ~Node() = default;
-
-  /// <summary>
-  /// Get all neighbouring nodes.
-  /// </summary>
-  /// <returns>An array/vector of Node objects that are permutations of the
-  /// current node.</returns>
-  std::vector<std::shared_ptr<Node>> getNeighbours() const {
-    std::vector<std::shared_ptr<Node>> neighbours{};
-
-    auto states = board->getPossibleStates();
-
-    for (const Board &b : states) {
-      Node child(b);
-      child.parent = std::make_shared<Node>(*this);
-      neighbours.emplace_back(std::make_shared<Node>(child));
-    }
-
-    return neighbours;
-  }
-
-  std::shared_ptr<Board> board;
-  std::shared_ptr<Node> parent;
-  int g_value;
-  int h_value;
-  int f_value;
-};
-
-/// <summary>
-/// A function to return an array of Board objects representing the solution to
-/// the puzzle.
-/// The function will iterate over the parent of the current node to reconstruct
-/// the shortest possible solution.
-/// </summary>
-std::vector<std::shared_ptr<Board>> reconstructPath(
-    const std::unordered_map<std::shared_ptr<Node>, std::shared_ptr<Node>>
-        &came_from,
-    const std::shared_ptr<Node> &current);
-
-/// <summary>
-/// A function to return the heuristic value for the current board position.
-/// </summary>
-int calculateHValue(const Node &current);
-
-/// <summary>
-/// The A* search function to find the shortest solution to the board puzzle.
-/// </summary>
-std::vector<std::shared_ptr<Board>> search(const Board &board);
-}  // namespace AStar
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "Board.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+class Layout;
+
+namespace AStar {
+/// <summary>
+/// A flag shared by the copies of a token, set once to ask the searches
+/// holding a copy to stop.
+/// </summary>
+class CancellationToken {
+ public:
+  CancellationToken() : flag_{std::make_shared<std::atomic<bool>>(false)} {}
+
+  /// <summary>
+  /// Ask every search holding a copy of the token to stop.
+  /// </summary>
+  void cancel() noexcept {
+    this->flag_->store(true, std::memory_order_relaxed);
+  }
+
+  /// <summary>
+  /// Check if the token was cancelled.
+  /// </summary>
+  bool isCancelled() const noexcept {
+    return this->flag_->load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+/// <summary>
+/// Thrown by a search whose cancellation token was cancelled.
+/// </summary>
+class SearchCancelled : public std::runtime_error {
+ public:
+  SearchCancelled() : std::runtime_error{"Search cancelled"} {}
+};
+
+struct Options {
+  /// <summary>
+  /// How the cost of a path is counted: the number of cells cars moved, or
+  /// the number of moves made regardless of their length.
+  /// </summary>
+  enum class Cost { Cells, Slides };
+
+  /// <summary>
+  /// Options controlling which neighbours of a node are generated.
+  /// </summary>
+  Board::GenerationOptions generation{};
+
+  Cost cost{Cost::Cells};
+
+  /// <summary>
+  /// Queue generated nodes on their parent's f value and evaluate the
+  /// heuristic only when a node is popped from the open list.
+  /// </summary>
+  bool lazy_heuristic{false};
+
+  /// <summary>
+  /// The weight of the heuristic, states are ordered on f = g + weight * h.
+  /// A weight above 1 finds a solution faster, costing at most weight times
+  /// the optimal cost.
+  /// </summary>
+  double weight{1.0};
+
+  /// <summary>
+  /// Returns the exact cost from a board to a solution, or -1 if it is not
+  /// known. search() stops at the first board with a known cost that lies on
+  /// a shortest path, the caller continues the solution from there.
+  /// </summary>
+  std::function<int(const Board &)> known_cost{};
+
+  /// <summary>
+  /// Checked while expanding states, search() throws SearchCancelled once it
+  /// is cancelled.
+  /// </summary>
+  CancellationToken cancellation{};
+};
+
+struct AnytimeOptions {
+  /// <summary>
+  /// The weight of the heuristic for the first solution.
+  /// </summary>
+  double initial_weight{3.0};
+
+  /// <summary>
+  /// How much the weight is lowered after each solution, until it reaches 1.
+  /// </summary>
+  double weight_step{0.5};
+
+  /// <summary>
+  /// The time after which the search returns the best solution found so far.
+  /// </summary>
+  std::chrono::steady_clock::time_point deadline{
+      std::chrono::steady_clock::time_point::max()};
+};
+
+/// <summary>
+/// A function called with each improved solution and the weight it was found
+/// with, the solution costs at most weight times the optimal cost.
+/// </summary>
+using SolutionCallback = std::function<void(
+    const std::vector<std::shared_ptr<Board>> &path, double weight)>;
+
+struct Node : public std::enable_shared_from_this<Node> {
+  /// <summary>
+  /// A constructor for Node object.
+  /// </summary>
+  /// <param name="board">A Board object container positions of all
+  /// cars. The board is moved into the node when passed as an
+  /// rvalue.</param>
+  explicit Node(Board board)
+      : board{std::make_shared<Board>(std::move(board))},
+        parent{nullptr},
+        g_value{0},
+        h_value{0},
+        f_value{0},
+        h_evaluated{false} {};
+
+  /// <summary>
+  /// Default constructor.
+  /// </summary>
+  Node() = default;
+
+  /// <summary>
+  /// Default destructor.
+  /// </summary>
+  ~Node() = default;
+
+  /// <summary>
+  /// Get all neighbouring nodes.
+  /// </summary>
+  /// <param name="options">Options controlling which moves are
+  /// generated.</param>
+  /// <returns>An array/vector of Node objects that are permutations of the
+  /// current node.</returns>
+  std::vector<std::shared_ptr<Node>> getNeighbours(
+      const Board::GenerationOptions &options = {}) const {
+    std::vector<std::shared_ptr<Node>> neighbours{};
+
+    auto states = board->getPossibleStates(options);
+    neighbours.reserve(states.size());
+
+    // Share the parent with all children instead of copying it per child
+    std::shared_ptr<const Node> self = this->weak_from_this().lock();
+    if (self == nullptr) {
+      self = std::make_shared<Node>(*this);
+    }
+
+    for (Board &b : states) {
+      auto child = std::make_shared<Node>(std::move(b));
+      child->parent = self;
+      neighbours.emplace_back(std::move(child));
+    }
+
+    return neighbours;
+  }
+
+  std::shared_ptr<Board> board;
+  std::shared_ptr<const Node> parent;
+  int g_value;
+  int h_value;
+  int f_value;
+  bool h_evaluated;
+};
+
+/// <summary>
+/// A function to return an array of Board objects representing the solution to
+/// the puzzle.
+/// The function will iterate over the parent of the current node to reconstruct
+/// the shortest possible solution.
+/// </summary>
+std::vector<std::shared_ptr<Board>> reconstructPath(
+    const std::shared_ptr<const Node> &current);
+
+/// <summary>
+/// A function to return the moves between consecutive boards of a solution
+/// path.
+/// </summary>
+std::vector<Move> getMoves(const std::vector<std::shared_ptr<Board>> &path);
+
+/// <summary>
+/// A function to return the heuristic value for the current board position.
+/// </summary>
+int calculateHValue(const Node &current);
+
+/// <summary>
+/// A function to return the heuristic value for a board position.
+/// </summary>
+int calculateHValue(const Board &board);
+
+/// <summary>
+/// A function to return the heuristic values for a batch of packed states of
+/// a layout, equal to calculateHValue of their boards.
+/// With AVX2, four states are evaluated at once: the cells ahead of the main
+/// car are masked out of each state's occupancy and counted with a vector
+/// popcount.
+/// </summary>
+/// <param name="states">An array of packed states.</param>
+/// <param name="count">The number of states.</param>
+/// <param name="h_values">An array receiving the heuristic value of each
+/// state.</param>
+void calculateHValues(const Layout &layout, const std::uint64_t *states,
+                      std::size_t count, int *h_values);
+
+/// <summary>
+/// A function to return the heuristic value for the current board position
+/// from the heuristic value of its parent and the last move, without scanning
+/// the board. Falls back to calculateHValue for a node without a parent.
+/// </summary>
+int updateHValue(const Node &current);
+
+/// <summary>
+/// A function to return the heuristic value for a board position from the
+/// heuristic value of the board it was moved from.
+/// </summary>
+int updateHValue(const Board &board, int parent_h);
+
+class Workspace;
+
+/// <summary>
+/// The boards of a solution from the start to the solved board, read one at
+/// a time from the states of the search that found it instead of copied
+/// into a path. Each board but the first records the move that produced it
+/// in Board::getLastMove. A range is valid until its workspace is used for
+/// another search or destroyed.
+/// </summary>
+class SolutionRange {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Board;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Board *;
+    using reference = const Board &;
+
+    Iterator() = default;
+
+    const Board &operator*() const;
+
+    const Board *operator->() const { return &**this; }
+
+    Iterator &operator++();
+
+    Iterator operator++(int) {
+      Iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const Iterator &other) const noexcept {
+      return this->index_ == other.index_;
+    }
+
+    bool operator!=(const Iterator &other) const noexcept {
+      return !(*this == other);
+    }
+
+   private:
+    friend class SolutionRange;
+
+    Iterator(const Workspace *workspace, std::uint32_t index)
+        : workspace_{workspace}, index_{index} {}
+
+    const Workspace *workspace_{nullptr};
+    std::uint32_t index_{UINT32_MAX};
+  };
+
+  /// <summary>
+  /// A constructor for creating an empty range.
+  /// </summary>
+  SolutionRange() = default;
+
+  Iterator begin() const { return Iterator{this->workspace_, this->start_}; }
+
+  Iterator end() const { return Iterator{this->workspace_, UINT32_MAX}; }
+
+  /// <summary>
+  /// Check if the search found no solution.
+  /// </summary>
+  bool empty() const noexcept { return this->size_ == 0; }
+
+  /// <summary>
+  /// Default getter for the number of boards, the start included.
+  /// </summary>
+  std::size_t size() const noexcept { return this->size_; }
+
+ private:
+  friend SolutionRange searchRange(const Board &board, const Options &options,
+                                   Workspace &workspace);
+
+  const Workspace *workspace_{nullptr};
+  std::uint32_t start_{UINT32_MAX};
+  std::size_t size_{0};
+};
+
+/// <summary>
+/// Memory kept between searches: the state table, boards and open list of
+/// the last search. Reusing a workspace for consecutive searches avoids
+/// allocating and growing them again. A workspace is used by one search at a
+/// time.
+/// </summary>
+class Workspace {
+ public:
+  Workspace();
+  ~Workspace();
+  Workspace(const Workspace &) = delete;
+  Workspace &operator=(const Workspace &) = delete;
+
+ private:
+  friend std::vector<std::shared_ptr<Board>> search(const Board &board,
+                                                    const Options &options,
+                                                    Workspace &workspace);
+  friend SolutionRange searchRange(const Board &board, const Options &options,
+                                   Workspace &workspace);
+  friend class SolutionRange::Iterator;
+
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+/// <summary>
+/// The A* search function to find the shortest solution to the board puzzle.
+/// </summary>
+std::vector<std::shared_ptr<Board>> search(const Board &board,
+                                           const Options &options = {});
+
+/// <summary>
+/// The A* search function to find the shortest solution to the board puzzle,
+/// reusing the memory of a workspace.
+/// </summary>
+std::vector<std::shared_ptr<Board>> search(const Board &board,
+                                           const Options &options,
+                                           Workspace &workspace);
+
+/// <summary>
+/// The A* search function to find the shortest solution to the board puzzle,
+/// returning the solution as a range over the workspace instead of a path.
+/// The boards of the solution are not copied, so a caller streaming the
+/// moves can start as soon as the solved board is found.
+/// </summary>
+SolutionRange searchRange(const Board &board, const Options &options,
+                          Workspace &workspace);
+
+/// <summary>
+/// Run search() on a thread of its own. Cancel the token in options to
+/// abandon the search, the future then throws SearchCancelled.
+/// </summary>
+std::future<std::vector<std::shared_ptr<Board>>> searchAsync(
+    Board board, Options options = {});
+
+/// <summary>
+/// An anytime A* search (ARA*). A weighted search finds a first solution
+/// quickly, then the weight is lowered step by step, reusing the states
+/// already expanded, until the solution is proven optimal or the deadline
+/// passes or the cancellation token is cancelled. Options::weight,
+/// Options::lazy_heuristic and Options::known_cost are not used.
+/// </summary>
+/// <param name="callback">Called with each improved solution.</param>
+/// <returns>The best solution found, empty if none was found.</returns>
+std::vector<std::shared_ptr<Board>> anytimeSearch(
+    const Board &board, const Options &options = {},
+    const AnytimeOptions &anytime_options = {},
+    const SolutionCallback &callback = nullptr);
+}  // namespace AStar
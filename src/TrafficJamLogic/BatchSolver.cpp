@@ -0,0 +1,192 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "BatchSolver.h"
+
+#include "AStar.h"
+#include "Layout.h"
+#include "StateRank.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+constexpr std::uint8_t kUnreached = UINT8_MAX;
+// The number of states expanded at once
+constexpr std::size_t kBatchSize = 64;
+
+/// <summary>
+/// The number of moves from every state of a layout to its nearest solved
+/// state, indexed by StateRank.
+/// </summary>
+class DistanceMap {
+ public:
+  explicit DistanceMap(const Layout &layout)
+      : layout_{layout}, ranking_{layout_},
+        distances_(ranking_.getSize(), kUnreached) {
+    std::vector<std::uint64_t> frontier{};
+    std::vector<std::uint64_t> next{};
+    std::vector<std::uint64_t> successors{};
+
+    // Seed the search with every legal solved state
+    this->addSolved(0, 0, 0, frontier);
+
+    // Moves are reversible, so searching forwards from the solved states
+    // gives the distance of every state to the goal
+    for (std::uint8_t depth = 1; !frontier.empty() && depth < kUnreached;
+         ++depth) {
+      next.clear();
+      for (std::size_t i = 0; i < frontier.size(); i += kBatchSize) {
+        successors.clear();
+        this->layout_.getSuccessors(frontier.data() + i,
+                                    std::min(kBatchSize, frontier.size() - i),
+                                    successors);
+        for (const auto &s : successors) {
+          auto &distance = this->distances_[this->ranking_.rank(s)];
+          if (distance == kUnreached) {
+            distance = depth;
+            next.emplace_back(s);
+          }
+        }
+      }
+      frontier.swap(next);
+    }
+    this->complete_ = frontier.empty();
+  }
+
+  std::vector<std::shared_ptr<Board>> getPath(std::uint64_t state) const {
+    auto distance = this->distances_[this->ranking_.rank(state)];
+    std::vector<std::shared_ptr<Board>> path{};
+
+    // States further than the distance type can count are solved directly
+    if (distance == kUnreached) {
+      return this->complete_ ? path
+                             : AStar::search(this->layout_.decode(state));
+    }
+
+    // Follow any neighbour one move closer to the goal
+    std::vector<std::uint64_t> successors{};
+    path.emplace_back(std::make_shared<Board>(this->layout_.decode(state)));
+    while (distance > 0) {
+      successors.clear();
+      this->layout_.getSuccessors(state, successors);
+      for (const auto &s : successors) {
+        if (this->distances_[this->ranking_.rank(s)] == distance - 1) {
+          state = s;
+          break;
+        }
+      }
+      --distance;
+      path.emplace_back(std::make_shared<Board>(this->layout_.decode(state)));
+    }
+
+    return path;
+  }
+
+ private:
+  /// <summary>
+  /// Place the cars from an index on in every position that overlaps no car
+  /// placed before, with the main car at the end of its row, and record the
+  /// solved states. Only solved states are visited, not the whole ranking.
+  /// </summary>
+  void addSolved(int index, std::uint64_t state, std::uint64_t occupancy,
+                 std::vector<std::uint64_t> &solved) {
+    const auto &layout = this->layout_;
+    if (index == layout.getCarCount()) {
+      this->distances_[this->ranking_.rank(state)] = 0;
+      solved.emplace_back(state);
+      return;
+    }
+
+    // Cars of a lane keep their order, as StateRank ranks them
+    const int last = layout.getBoardSize() - layout.getLength(index);
+    int first = 0;
+    if (index > 0 && layout.getDirection(index) ==
+                         layout.getDirection(index - 1) &&
+        layout.getLane(index) == layout.getLane(index - 1)) {
+      first = Layout::getPosition(state, index - 1) +
+              layout.getLength(index - 1);
+    }
+    if (index == layout.getMainIndex()) {
+      first = std::max(first, last);
+    }
+    for (auto position = first; position <= last; ++position) {
+      const auto mask = this->layout_.getCarMask(index, position);
+      if (!(occupancy & mask)) {
+        this->addSolved(index + 1, Layout::setPosition(state, index, position),
+                        occupancy | mask, solved);
+      }
+    }
+  }
+
+  Layout layout_;
+  StateRank ranking_;
+  std::vector<std::uint8_t> distances_;
+  bool complete_{true};
+};
+}  // namespace
+
+BatchSolver::BatchSolver(const Options &options) : options_{options} {}
+
+std::size_t BatchSolver::add(Board board) {
+  const auto index = this->size();
+  try {
+    this->compact_boards_.emplace_back(index, CompactBoard{board});
+  } catch (const std::invalid_argument &) {
+    // Boards too large to pack, or with IDs beyond a byte, are solved on
+    // their own
+    this->boards_.emplace_back(index, std::move(board));
+  }
+  return index;
+}
+
+std::size_t BatchSolver::add(const CompactBoard &board) {
+  const auto index = this->size();
+  this->compact_boards_.emplace_back(index, board);
+  return index;
+}
+
+std::vector<std::vector<std::shared_ptr<Board>>> BatchSolver::solve() {
+  std::vector<std::vector<std::shared_ptr<Board>>> solutions(this->size());
+  for (const auto &board : this->boards_) {
+    solutions[board.first] = AStar::search(board.second);
+  }
+
+  // Boards are grouped on the key of their layout, the Layout itself is only
+  // built once per group
+  std::unordered_map<std::string,
+                     std::vector<const std::pair<std::size_t, CompactBoard> *>>
+      groups{};
+  for (const auto &board : this->compact_boards_) {
+    groups[board.second.getLayoutKey()].emplace_back(&board);
+  }
+
+  for (const auto &group : groups) {
+    const auto &members = group.second;
+    const Layout layout{members.front()->second.toBoard()};
+
+    if (members.size() >= this->options_.min_group_size &&
+        StateRank{layout}.getSize() <= this->options_.max_bytes) {
+      const DistanceMap distances{layout};
+      for (const auto *board : members) {
+        solutions[board->first] = distances.getPath(board->second.getState());
+      }
+    } else {
+      for (const auto *board : members) {
+        solutions[board->first] = AStar::search(board->second.toBoard());
+      }
+    }
+  }
+
+  this->compact_boards_.clear();
+  this->boards_.clear();
+  return solutions;
+}
+
+std::size_t BatchSolver::size() const noexcept {
+  return this->compact_boards_.size() + this->boards_.size();
+}
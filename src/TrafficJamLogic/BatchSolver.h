@@ -0,0 +1,80 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "Board.h"
+#include "CompactBoard.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// A solver for many boards at once.
+/// Boards are grouped by Layout. Groups with enough boards are answered from
+/// a single breadth-first search running backwards from every solved state of
+/// the layout, smaller groups are solved one board at a time with
+/// AStar::search.
+/// </summary>
+class BatchSolver {
+ public:
+  struct Options {
+    /// <summary>
+    /// The smallest group solved with a shared backward search.
+    /// </summary>
+    std::size_t min_group_size{8};
+
+    /// <summary>
+    /// The largest distance map allowed for a group, in bytes. Groups with a
+    /// larger layout are solved one board at a time.
+    /// </summary>
+    std::uint64_t max_bytes{std::uint64_t{1} << 30};
+  };
+
+  /// <summary>
+  /// A constructor for creating a BatchSolver object.
+  /// </summary>
+  explicit BatchSolver(const Options &options);
+
+  /// <summary>
+  /// Default constructor.
+  /// </summary>
+  BatchSolver() = default;
+
+  /// <summary>
+  /// Queue a board to be solved.
+  /// </summary>
+  /// <returns>The index of the board's solution in the result of
+  /// solve().</returns>
+  std::size_t add(Board board);
+
+  /// <summary>
+  /// Queue a compact board to be solved. A compact board is grouped by its
+  /// layout without building a Board, unless it is solved on its own.
+  /// </summary>
+  /// <returns>The index of the board's solution in the result of
+  /// solve().</returns>
+  std::size_t add(const CompactBoard &board);
+
+  /// <summary>
+  /// Solve every queued board and empty the queue.
+  /// </summary>
+  /// <returns>The solution path of each board in the order the boards were
+  /// added, empty for boards that cannot be solved.</returns>
+  std::vector<std::vector<std::shared_ptr<Board>>> solve();
+
+  /// <summary>
+  /// Default getter for the number of queued boards.
+  /// </summary>
+  std::size_t size() const noexcept;
+
+ private:
+  Options options_;
+  // Queued boards with the index of their solution. Boards too large for a
+  // Layout are kept as Board objects
+  std::vector<std::pair<std::size_t, CompactBoard>> compact_boards_;
+  std::vector<std::pair<std::size_t, Board>> boards_;
+};
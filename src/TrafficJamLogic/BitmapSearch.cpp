@@ -0,0 +1,91 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "BitmapSearch.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+// The number of states expanded at once
+constexpr std::size_t kBatchSize = 64;
+}  // namespace
+
+std::vector<std::shared_ptr<Board>> BitmapSearch::search(
+    const Board &board, std::uint64_t max_bytes) {
+  const Layout layout{board};
+  const StateRank ranking{layout};
+
+  if (ranking.getSize() / 4 > max_bytes) {
+    throw std::length_error("Layout has too many states for a bitmap search");
+  }
+
+  DistanceArray distances{ranking.getSize()};
+  auto start = layout.encode(board);
+  auto goal = start;
+  auto depth = 0;
+  bool found = layout.solved(start);
+
+  std::vector<std::uint64_t> frontier{start};
+  std::vector<std::uint64_t> next{};
+  std::vector<std::uint64_t> successors{};
+  distances.visit(ranking.rank(start), 0);
+
+  // Expand one layer at a time until a solved state is reached. The states
+  // of a layer are expanded in batches, so that the successors of a batch
+  // are generated together before any of them is ranked
+  while (!found && !frontier.empty()) {
+    next.clear();
+    for (std::size_t i = 0; i < frontier.size(); i += kBatchSize) {
+      successors.clear();
+      layout.getSuccessors(frontier.data() + i,
+                           std::min(kBatchSize, frontier.size() - i),
+                           successors);
+
+      for (const auto &s : successors) {
+        auto rank = ranking.rank(s);
+        if (distances.visited(rank)) {
+          continue;
+        }
+        distances.visit(rank, depth + 1);
+        next.emplace_back(s);
+
+        if (layout.solved(s)) {
+          goal = s;
+          found = true;
+          break;
+        }
+      }
+
+      if (found) {
+        break;
+      }
+    }
+    frontier.swap(next);
+    ++depth;
+  }
+
+  if (!found) {
+    return {};
+  }
+
+  // Walk back from the goal through neighbours one layer closer to the start
+  std::vector<std::uint64_t> states{goal};
+  for (auto d = depth - 1; d >= 0; --d) {
+    successors.clear();
+    layout.getSuccessors(states.back(), successors);
+    states.emplace_back(*std::find_if(
+        successors.begin(), successors.end(), [&](const std::uint64_t &s) {
+          return distances.atDepth(ranking.rank(s), d);
+        }));
+  }
+
+  std::vector<std::shared_ptr<Board>> path{};
+  path.reserve(states.size());
+  for (auto it = states.rbegin(); it != states.rend(); ++it) {
+    path.emplace_back(std::make_shared<Board>(layout.decode(*it)));
+  }
+
+  return path;
+}
@@ -0,0 +1,73 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "Board.h"
+#include "Layout.h"
+#include "StateRank.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// An array of 2-bit values indexed by state rank.
+/// A value of 0 marks an unvisited state, 1 to 3 hold the breadth-first depth
+/// of a visited state modulo 3. Neighbouring states differ in depth by at most
+/// one, which is enough to walk from any state back to the start.
+/// </summary>
+class DistanceArray {
+ public:
+  /// <summary>
+  /// A constructor for creating an array of unvisited states.
+  /// </summary>
+  /// <param name="size">The number of states.</param>
+  explicit DistanceArray(std::uint64_t size)
+      : words_((size + 31) / 32, 0) {};
+
+  /// <summary>
+  /// Check if a state has been visited.
+  /// </summary>
+  bool visited(std::uint64_t rank) const noexcept {
+    return this->getValue(rank) != 0;
+  }
+
+  /// <summary>
+  /// Check if a visited state was found at a depth.
+  /// </summary>
+  bool atDepth(std::uint64_t rank, int depth) const noexcept {
+    return this->getValue(rank) == static_cast<std::uint64_t>(depth % 3 + 1);
+  }
+
+  /// <summary>
+  /// Mark a state as visited at a depth.
+  /// </summary>
+  void visit(std::uint64_t rank, int depth) noexcept {
+    this->words_[rank / 32] |= static_cast<std::uint64_t>(depth % 3 + 1)
+                               << (2 * (rank % 32));
+  }
+
+ private:
+  std::uint64_t getValue(std::uint64_t rank) const noexcept {
+    return (this->words_[rank / 32] >> (2 * (rank % 32))) & 3;
+  }
+
+  std::vector<std::uint64_t> words_;
+};
+
+namespace BitmapSearch {
+/// <summary>
+/// A breadth-first search for the shortest solution to the board puzzle.
+/// Visited states are kept in a DistanceArray indexed by StateRank, 2 bits
+/// per state of the layout instead of a set of boards.
+/// Throws std::length_error if the array would take more than max_bytes.
+/// </summary>
+/// <param name="board">The board to solve.</param>
+/// <param name="max_bytes">The largest DistanceArray allowed.</param>
+/// <returns>The boards from the start to the solved board, empty if the board
+/// cannot be solved.</returns>
+std::vector<std::shared_ptr<Board>> search(
+    const Board &board, std::uint64_t max_bytes = std::uint64_t{1} << 30);
+}  // namespace BitmapSearch
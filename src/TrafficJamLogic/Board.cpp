@@ -1,190 +1,368 @@
-/**
- * Copyright 2019 Martin Pham
- */
-
-#include "Board.h"
-
-#include <cmath>
-
-Board::Board(const std::unordered_map<int, Car> &cars, const int &board_size,
-             const int &main_id)
-    : cars_{cars}, board_size_{board_size}, main_id_{main_id} {
-  this->updateGameBoard();
-};
-
-Board::Board(const std::vector<int> &game_board, const int &main_id)
-    : game_board_{game_board},
-      board_size_{static_cast<int>(std::sqrt(game_board.size()))},
-      main_id_{main_id} {
-  this->updateCars();
-};
-
-void Board::updateCars() {
-  this->cars_ = std::unordered_map<int, Car>{};
-  // Get horizontal cars
-  for (auto i = 0; i < this->board_size_; ++i) {
-    for (auto j = 0; j < this->board_size_; ++j) {
-      auto current_id = this->getGameBoardAt(i, j);
-      auto length = 0;
-      if (current_id != 0) {
-        for (auto k = j; k < this->board_size_; ++k) {
-          if (this->getGameBoardAt(i, k) == current_id) {
-            ++length;
-          }
-        }
-        if (length > 1) {
-          this->cars_.emplace(current_id,
-                              Car{current_id, i, j, length, Car::Horizontal});
-        }
-        j += length;
-      }
-    }
-  }
-  // Get vertical cars
-  for (auto i = 0; i < this->board_size_; ++i) {
-    for (auto j = 0; j < this->board_size_; ++j) {
-      auto current_id = this->getGameBoardAt(this->board_size_ - j - 1, i);
-      auto length = 0;
-      if (current_id != 0) {
-        for (auto k = j; k < this->board_size_; ++k) {
-          if (this->getGameBoardAt(this->board_size_ - k - 1, i) ==
-              current_id) {
-            ++length;
-          }
-        }
-        if (length > 1) {
-          this->cars_.emplace(
-              current_id, Car{current_id, this->board_size_ - j - 1, i, length,
-                              Car::Vertical});
-        }
-        j += length - 1;
-      }
-    }
-  }
-}
-
-void Board::printCars() const noexcept {
-  for (const auto &c : this->cars_) {
-    std::cout << c.second << '\n';
-  }
-  std::cout << '\n';
-}
-
-bool Board::solved() const {
-  auto main_car = this->cars_.at(this->main_id_);
-  return main_car.getPosCol() + main_car.getLength() == this->board_size_;
-}
-
-void Board::updateGameBoard() {
-  // static casting to avoid integer overflow
-  this->game_board_ =
-      std::vector<int>(static_cast<uint64_t>(this->board_size_) *
-                       static_cast<uint64_t>(this->board_size_));
-
-  if (this->cars_.size() > 0) {
-    for (const auto &c : this->cars_) {
-      const Car &current_car = c.second;
-      if (current_car.getDirection() == Car::Direction::Horizontal) {
-        for (auto i = 0; i < current_car.getLength(); ++i) {
-          this->setGameBoardAt(current_car.getPosRow(),
-                               current_car.getPosCol() + i,
-                               current_car.getId());
-        }
-      } else {
-        for (auto i = 0; i < current_car.getLength(); ++i) {
-          this->setGameBoardAt(
-              current_car.getPosRow() + 1 - current_car.getLength() + i,
-              current_car.getPosCol(), current_car.getId());
-        }
-      }
-    }
-  }
-}
-
-std::vector<Board> Board::getPossibleStates() const {
-  std::vector<Board> states{};
-  std::unordered_map<int, Car> cars_copy;
-
-  // For each car in the board
-  for (const auto &c : this->cars_) {
-    Car current_car = c.second;
-    auto cur_id = current_car.getId();
-    auto cur_row = current_car.getPosRow();
-    auto cur_col = current_car.getPosCol();
-    auto cur_length = current_car.getLength();
-    auto cur_direction = current_car.getDirection();
-
-    if (cur_direction == Car::Direction::Horizontal) {
-      // Move left
-      if ((cur_col >= 1) && this->getGameBoardAt(cur_row, cur_col - 1) == 0) {
-        Car new_car{cur_id, cur_row, cur_col - 1, cur_length, cur_direction};
-        cars_copy = std::unordered_map<int, Car>(this->cars_);
-        cars_copy[cur_id] = new_car;
-        states.emplace_back(cars_copy);
-      }
-
-      // Move right
-      if ((cur_col + cur_length <= this->board_size_ - 1) &&
-          this->getGameBoardAt(cur_row, cur_col + cur_length) == 0) {
-        Car new_car{cur_id, cur_row, cur_col + 1, cur_length, cur_direction};
-        cars_copy = std::unordered_map<int, Car>(this->cars_);
-        cars_copy[cur_id] = new_car;
-        states.emplace_back(cars_copy);
-      }
-    } else {
-      // Move up
-      if ((cur_row + 1 - cur_length >= 1) &&
-          this->getGameBoardAt(cur_row + 1 - cur_length - 1, cur_col) == 0) {
-        Car new_car{cur_id, cur_row - 1, cur_col, cur_length, cur_direction};
-        cars_copy = std::unordered_map<int, Car>(this->cars_);
-        cars_copy[cur_id] = new_car;
-        states.emplace_back(cars_copy);
-      }
-
-      // Move down
-      if ((cur_row + 1 <= this->board_size_ - 1) &&
-          this->getGameBoardAt(cur_row + 1, cur_col) == 0) {
-        Car new_car{cur_id, cur_row + 1, cur_col, cur_length, cur_direction};
-        cars_copy = std::unordered_map<int, Car>(this->cars_);
-        cars_copy[cur_id] = new_car;
-        states.emplace_back(cars_copy);
-      }
-    }
-  }
-
-  return states;
-}
-
-Car Board::getCar(const int &id) const { return this->cars_.at(id); }
-
-std::vector<int> Board::getGameBoard() const noexcept {
-  return this->game_board_;
-}
-
-int Board::getGameBoardAt(const int &row, const int &col) const {
-  // static casting to avoid integer overflow
-  return this->game_board_[static_cast<uint64_t>(
-                               static_cast<uint64_t>(row) *
-                               static_cast<uint64_t>(this->board_size_)) +
-                           col];
-}
-
-void Board::setGameBoardAt(const int &row, const int &col, const int &value) {
-  // static casting to avoid integer overflow
-  this->game_board_[static_cast<uint64_t>(
-                        static_cast<uint64_t>(row) *
-                        static_cast<uint64_t>(this->board_size_)) +
-                    col] = value;
-}
-
-std::unordered_map<int, Car> Board::getCars() const noexcept {
-  return this->cars_;
-}
-
-int Board::getBoardSize() const noexcept { return this->board_size_; }
-
-int Board::getMainId() const noexcept { return this->main_id_; }
-
-Car Board::getMainCar() const noexcept {
-  return this->cars_.at(this->main_id_);
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "Board.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TRAFFIC_JAM_SSE2
+#endif
+
+namespace {
+/// <summary>
+/// Set bit k of bits if lhs[k] is a car and lhs[k] == rhs[k].
+/// </summary>
+void compareCells(const int *lhs, const int *rhs, std::size_t count,
+                  uint64_t *bits) {
+  std::size_t k = 0;
+
+#if defined(__AVX2__)
+  const __m256i zero8 = _mm256_setzero_si256();
+  for (; k + 8 <= count; k += 8) {
+    auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + k));
+    auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + k));
+    auto same = _mm256_andnot_si256(_mm256_cmpeq_epi32(a, zero8),
+                                    _mm256_cmpeq_epi32(a, b));
+    auto mask = static_cast<uint64_t>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(same)));
+    bits[k / 64] |= mask << (k % 64);
+  }
+#endif
+
+#if defined(__AVX2__) || defined(TRAFFIC_JAM_SSE2)
+  const __m128i zero4 = _mm_setzero_si128();
+  for (; k + 4 <= count; k += 4) {
+    auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs + k));
+    auto b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + k));
+    auto same =
+        _mm_andnot_si128(_mm_cmpeq_epi32(a, zero4), _mm_cmpeq_epi32(a, b));
+    auto mask =
+        static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(same)));
+    bits[k / 64] |= mask << (k % 64);
+  }
+#endif
+
+  for (; k < count; ++k) {
+    if (lhs[k] != 0 && lhs[k] == rhs[k]) {
+      bits[k / 64] |= uint64_t{1} << (k % 64);
+    }
+  }
+}
+
+/// <summary>
+/// The cells a car covers before, during and after a move: a range of
+/// positions along its lane.
+/// </summary>
+struct Sweep {
+  bool horizontal;
+  int lane;
+  int first;
+  int last;
+
+  bool intersects(const Sweep &other) const noexcept {
+    if (this->horizontal == other.horizontal) {
+      return this->lane == other.lane && this->first <= other.last &&
+             other.first <= this->last;
+    }
+    // Crossing lanes share the cell where they meet
+    return this->first <= other.lane && other.lane <= this->last &&
+           other.first <= this->lane && this->lane <= other.last;
+  }
+};
+
+/// <summary>
+/// Get the sweep of a car moving from offset to offset + delta cells away
+/// from its current position.
+/// </summary>
+Sweep getSweep(const Car &car, int offset, int delta) {
+  const bool horizontal = car.getDirection() == Car::Direction::Horizontal;
+  const int lane = horizontal ? car.getPosRow() : car.getPosCol();
+  const int position = (horizontal ? car.getPosCol()
+                                   : car.getPosRow() + 1 - car.getLength()) +
+                       offset;
+  return Sweep{horizontal, lane, std::min(position, position + delta),
+               std::max(position, position + delta) + car.getLength() - 1};
+}
+}  // namespace
+
+Board::Board(std::unordered_map<int, Car> cars, const int &board_size,
+             const int &main_id)
+    : cars_{std::move(cars)}, board_size_{board_size}, main_id_{main_id} {
+  this->updateGameBoard();
+};
+
+Board::Board(const std::vector<int> &game_board, const int &main_id)
+    : game_board_{game_board},
+      board_size_{static_cast<int>(std::sqrt(game_board.size()))},
+      main_id_{main_id} {
+  this->updateCars();
+};
+
+void Board::updateCars() {
+  this->cars_ = std::unordered_map<int, Car>{};
+
+  const auto size = static_cast<std::size_t>(this->board_size_);
+  const auto cells = this->game_board_.size();
+  const int *board = this->game_board_.data();
+  std::vector<uint64_t> right_same((cells + 63) / 64);
+  std::vector<uint64_t> down_same((cells + 63) / 64);
+
+  // Mark every cell that belongs to the same car as its right and bottom
+  // neighbours, comparing the flattened board against itself shifted by one
+  // cell and by one row
+  if (cells > 1) {
+    compareCells(board, board + 1, cells - 1, right_same.data());
+  }
+  if (cells > size) {
+    compareCells(board, board + size, cells - size, down_same.data());
+  }
+  // The last cell of a row is not adjacent to the first cell of the next row
+  for (std::size_t k = size - 1; k < cells; k += size) {
+    right_same[k / 64] &= ~(uint64_t{1} << (k % 64));
+  }
+
+  // Each car is found at its top-left cell and measured by following the
+  // neighbour bits, so every cell is visited once
+  auto is_set = [](const std::vector<uint64_t> &bits, std::size_t k) {
+    return (bits[k / 64] >> (k % 64)) & 1;
+  };
+  for (std::size_t k = 0; k < cells; ++k) {
+    auto current_id = board[k];
+    if (current_id == 0 || this->cars_.count(current_id)) {
+      continue;
+    }
+
+    auto row = static_cast<int>(k / size);
+    auto col = static_cast<int>(k % size);
+    auto length = 1;
+
+    if (is_set(right_same, k)) {
+      while (is_set(right_same, k + length - 1)) {
+        ++length;
+      }
+      this->cars_.emplace(current_id,
+                          Car{current_id, row, col, length, Car::Horizontal});
+    } else if (is_set(down_same, k)) {
+      while (is_set(down_same, k + (length - 1) * size)) {
+        ++length;
+      }
+      // Vertical cars are positioned by their bottom cell
+      this->cars_.emplace(current_id, Car{current_id, row + length - 1, col,
+                                          length, Car::Vertical});
+    }
+  }
+}
+
+void Board::printCars() const noexcept {
+  for (const auto &c : this->cars_) {
+    std::cout << c.second << '\n';
+  }
+  std::cout << '\n';
+}
+
+bool Board::solved() const {
+  const Car &main_car = this->cars_.at(this->main_id_);
+  return main_car.getPosCol() + main_car.getLength() == this->board_size_;
+}
+
+void Board::updateGameBoard() {
+  // static casting to avoid integer overflow
+  this->game_board_ =
+      std::vector<int>(static_cast<uint64_t>(this->board_size_) *
+                       static_cast<uint64_t>(this->board_size_));
+
+  if (this->cars_.size() > 0) {
+    for (const auto &c : this->cars_) {
+      const Car &current_car = c.second;
+      if (current_car.getDirection() == Car::Direction::Horizontal) {
+        for (auto i = 0; i < current_car.getLength(); ++i) {
+          this->setGameBoardAt(current_car.getPosRow(),
+                               current_car.getPosCol() + i,
+                               current_car.getId());
+        }
+      } else {
+        for (auto i = 0; i < current_car.getLength(); ++i) {
+          this->setGameBoardAt(
+              current_car.getPosRow() + 1 - current_car.getLength() + i,
+              current_car.getPosCol(), current_car.getId());
+        }
+      }
+    }
+  }
+}
+
+std::vector<Board> Board::getPossibleStates() const {
+  return this->getPossibleStates(GenerationOptions{});
+}
+
+std::vector<Board> Board::getPossibleStates(
+    const GenerationOptions &options) const {
+  std::vector<Board> states{};
+
+  // For each car in the board
+  for (const auto &c : this->cars_) {
+    const Car &current_car = c.second;
+    auto cur_id = current_car.getId();
+    auto cur_length = current_car.getLength();
+    auto horizontal = current_car.getDirection() == Car::Direction::Horizontal;
+    // Walk along the car's lane: columns of its row or rows of its column
+    auto lane = horizontal ? current_car.getPosRow() : current_car.getPosCol();
+    auto first = horizontal ? current_car.getPosCol()
+                            : current_car.getPosRow() + 1 - cur_length;
+    auto last = first + cur_length - 1;
+    auto cell = [this, horizontal, lane](int position) {
+      return horizontal ? this->getGameBoardAt(lane, position)
+                        : this->getGameBoardAt(position, lane);
+    };
+    // A slide covers every free cell in a direction, a single step only one
+    auto max_steps = options.slide ? this->board_size_ : 1;
+
+    // Move left or up
+    for (auto step = 1;
+         step <= max_steps && first - step >= 0 && cell(first - step) == 0;
+         ++step) {
+      if (!(options.prune_transpositions &&
+            this->isTransposition(Move{cur_id, -step}, options))) {
+        states.emplace_back(this->applyMove(Move{cur_id, -step}));
+      }
+    }
+
+    // Move right or down
+    for (auto step = 1; step <= max_steps &&
+                        last + step < this->board_size_ &&
+                        cell(last + step) == 0;
+         ++step) {
+      if (!(options.prune_transpositions &&
+            this->isTransposition(Move{cur_id, step}, options))) {
+        states.emplace_back(this->applyMove(Move{cur_id, step}));
+      }
+    }
+  }
+
+  return states;
+}
+
+bool Board::isTransposition(const Move &move,
+                            const GenerationOptions &options) const {
+  const Move &last = this->last_move_;
+
+  if (last.car_id == 0) {
+    return false;
+  }
+
+  // Undoing the last move leads back to the parent. After a slide, moving
+  // the same car again is never shorter than a single slide from the parent
+  if (move.car_id == last.car_id) {
+    return options.slide || move.delta == -last.delta;
+  }
+
+  // Moves over disjoint cells commute, only the order with the lower car ID
+  // first is kept
+  if (move.car_id > last.car_id) {
+    return false;
+  }
+  auto last_sweep =
+      getSweep(this->cars_.at(last.car_id), -last.delta, last.delta);
+  auto move_sweep = getSweep(this->cars_.at(move.car_id), 0, move.delta);
+  return !last_sweep.intersects(move_sweep);
+}
+
+Board Board::applyMove(const Move &move) const {
+  // Copying the board and patching the cells of the moved car is cheaper than
+  // drawing every car onto a new board
+  Board state{*this};
+  state.last_move_ = move;
+  Car &car = state.cars_.at(move.car_id);
+  const bool horizontal = car.getDirection() == Car::Direction::Horizontal;
+  const int top = horizontal ? car.getPosRow()
+                             : car.getPosRow() + 1 - car.getLength();
+
+  for (auto i = 0; i < car.getLength(); ++i) {
+    if (horizontal) {
+      state.setGameBoardAt(top, car.getPosCol() + i, 0);
+    } else {
+      state.setGameBoardAt(top + i, car.getPosCol(), 0);
+    }
+  }
+
+  car = horizontal ? Car{car.getId(), car.getPosRow(),
+                         car.getPosCol() + move.delta, car.getLength(),
+                         car.getDirection()}
+                   : Car{car.getId(), car.getPosRow() + move.delta,
+                         car.getPosCol(), car.getLength(), car.getDirection()};
+
+  for (auto i = 0; i < car.getLength(); ++i) {
+    if (horizontal) {
+      state.setGameBoardAt(top, car.getPosCol() + i, car.getId());
+    } else {
+      state.setGameBoardAt(top + move.delta + i, car.getPosCol(), car.getId());
+    }
+  }
+
+  return state;
+}
+
+Move Board::getMoveTo(const Board &other) const {
+  for (const auto &c : this->cars_) {
+    const Car &current_car = c.second;
+    const Car &other_car = other.cars_.at(c.first);
+
+    if (current_car.getDirection() == Car::Direction::Horizontal &&
+        current_car.getPosCol() != other_car.getPosCol()) {
+      return Move{c.first, other_car.getPosCol() - current_car.getPosCol()};
+    }
+
+    if (current_car.getDirection() == Car::Direction::Vertical &&
+        current_car.getPosRow() != other_car.getPosRow()) {
+      return Move{c.first, other_car.getPosRow() - current_car.getPosRow()};
+    }
+  }
+
+  return Move{};
+}
+
+const Car &Board::getCar(const int &id) const { return this->cars_.at(id); }
+
+const std::vector<int> &Board::getGameBoard() const noexcept {
+  return this->game_board_;
+}
+
+int Board::getGameBoardAt(const int &row, const int &col) const {
+  // static casting to avoid integer overflow
+  return this->game_board_[static_cast<uint64_t>(
+                               static_cast<uint64_t>(row) *
+                               static_cast<uint64_t>(this->board_size_)) +
+                           col];
+}
+
+void Board::setGameBoardAt(const int &row, const int &col, const int &value) {
+  // static casting to avoid integer overflow
+  this->game_board_[static_cast<uint64_t>(
+                        static_cast<uint64_t>(row) *
+                        static_cast<uint64_t>(this->board_size_)) +
+                    col] = value;
+}
+
+const std::unordered_map<int, Car> &Board::getCars() const noexcept {
+  return this->cars_;
+}
+
+int Board::getBoardSize() const noexcept { return this->board_size_; }
+
+int Board::getMainId() const noexcept { return this->main_id_; }
+
+const Move &Board::getLastMove() const noexcept { return this->last_move_; }
+
+void Board::clearLastMove() noexcept { this->last_move_ = Move{}; }
+
+const Car &Board::getMainCar() const {
+  return this->cars_.at(this->main_id_);
 }
\ No newline at end of file
@@ -0,0 +1,234 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "CompactBoard.h"
+
+#include <algorithm>
+#include <bitset>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+// Car IDs written as letters, 'A' to 'Z'
+constexpr int kMaxLetters = 26;
+
+std::uint8_t toByte(int value, const char *name) {
+  if (value < 0 || value > UINT8_MAX) {
+    throw std::invalid_argument(std::string{name} + " " +
+                                std::to_string(value) +
+                                " does not fit in a byte");
+  }
+  return static_cast<std::uint8_t>(value);
+}
+}  // namespace
+
+CompactBoard CompactBoard::parse(const char *cells, std::size_t count) {
+  int size = 0;
+  while ((size + 1) * (size + 1) <= static_cast<int>(count)) {
+    ++size;
+  }
+  if (size * size != static_cast<int>(count)) {
+    throw std::invalid_argument("Board is not square");
+  }
+  if (size > Layout::kMaxBoardSize) {
+    throw std::invalid_argument("Board is too large for a packed layout");
+  }
+
+  // First cell, last cell and cell count of every letter, in one pass
+  std::array<int, kMaxLetters + 1> first{};
+  std::array<int, kMaxLetters + 1> last{};
+  std::array<int, kMaxLetters + 1> cell_count{};
+  for (auto i = 0; i < static_cast<int>(count); ++i) {
+    const char c = cells[i];
+    if (c == 'o' || c == '.') {
+      continue;
+    }
+    if (c < 'A' || c > 'Z') {
+      throw std::invalid_argument(std::string{"Invalid cell '"} + c + "'");
+    }
+    const int id = c - 'A' + 1;
+    if (cell_count[id]++ == 0) {
+      first[id] = i;
+    }
+    last[id] = i;
+  }
+
+  CompactBoard board{};
+  board.board_size_ = static_cast<std::uint8_t>(size);
+  board.main_id_ = 1;
+  for (auto id = 1; id <= kMaxLetters; ++id) {
+    const int length = cell_count[id];
+    if (length == 0) {
+      continue;
+    }
+    if (board.car_count_ == Layout::kMaxCars) {
+      throw std::invalid_argument("Board is too large for a packed layout");
+    }
+
+    // A car covers consecutive cells of a row or of a column
+    const int row = first[id] / size;
+    const int col = first[id] % size;
+    const bool horizontal = last[id] - first[id] == length - 1 &&
+                            last[id] / size == row;
+    const bool vertical = last[id] - first[id] == (length - 1) * size;
+    bool straight = length >= 2 && (horizontal || vertical);
+    for (auto k = 1; straight && k < length - 1; ++k) {
+      straight = cells[first[id] + k * (horizontal ? 1 : size)] ==
+                 cells[first[id]];
+    }
+    if (!straight) {
+      throw std::invalid_argument("Car " + std::string(1, cells[first[id]]) +
+                                  " is not a straight line of cells");
+    }
+
+    board.cars_[board.car_count_++] =
+        Car{static_cast<std::uint8_t>(id), static_cast<std::uint8_t>(length),
+            static_cast<std::uint8_t>(horizontal ? ::Car::Horizontal
+                                                 : ::Car::Vertical),
+            static_cast<std::uint8_t>(horizontal ? row : col),
+            static_cast<std::uint8_t>(horizontal ? col : row)};
+  }
+
+  // Catches a missing or vertical main car
+  board.validate();
+  board.sortCars();
+  return board;
+}
+
+CompactBoard::CompactBoard(const Board &board) {
+  const auto &cars = board.getCars();
+  if (board.getBoardSize() > Layout::kMaxBoardSize ||
+      cars.size() > static_cast<std::size_t>(Layout::kMaxCars)) {
+    throw std::invalid_argument("Board is too large for a packed layout");
+  }
+  this->board_size_ = toByte(board.getBoardSize(), "Board size");
+  this->main_id_ = toByte(board.getMainId(), "Main car ID");
+
+  for (const auto &c : cars) {
+    const ::Car &car = c.second;
+    const bool horizontal = car.getDirection() == ::Car::Horizontal;
+    this->cars_[this->car_count_++] = Car{
+        toByte(car.getId(), "Car ID"), toByte(car.getLength(), "Car length"),
+        toByte(car.getDirection(), "Car direction"),
+        toByte(horizontal ? car.getPosRow() : car.getPosCol(), "Car lane"),
+        toByte(horizontal ? car.getPosCol()
+                          : car.getPosRow() + 1 - car.getLength(),
+               "Car position")};
+  }
+
+  this->validate();
+  this->sortCars();
+}
+
+CompactBoard::CompactBoard(int board_size, int main_id, const Car *cars,
+                           int car_count) {
+  if (board_size > Layout::kMaxBoardSize || car_count > Layout::kMaxCars) {
+    throw std::invalid_argument("Board is too large for a packed layout");
+  }
+  this->board_size_ = toByte(board_size, "Board size");
+  this->main_id_ = toByte(main_id, "Main car ID");
+  this->car_count_ = toByte(car_count, "Car count");
+  std::copy(cars, cars + car_count, this->cars_.begin());
+
+  this->validate();
+  this->sortCars();
+}
+
+Board CompactBoard::toBoard() const {
+  std::unordered_map<int, ::Car> cars{};
+
+  for (auto i = 0; i < this->car_count_; ++i) {
+    const Car &car = this->cars_[i];
+    const auto direction = static_cast<::Car::Direction>(car.direction);
+    if (direction == ::Car::Horizontal) {
+      cars.emplace(car.id, ::Car{car.id, car.lane, car.position, car.length,
+                                 direction});
+    } else {
+      cars.emplace(car.id, ::Car{car.id, car.position + car.length - 1,
+                                 car.lane, car.length, direction});
+    }
+  }
+
+  return Board{std::move(cars), this->board_size_, this->main_id_};
+}
+
+std::string CompactBoard::getLayoutKey() const {
+  std::string key{static_cast<char>(this->board_size_),
+                  static_cast<char>(this->main_id_)};
+
+  for (auto i = 0; i < this->car_count_; ++i) {
+    const Car &car = this->cars_[i];
+    const int id = car.id;
+    key.append(reinterpret_cast<const char *>(&id), sizeof(int));
+    key.push_back(static_cast<char>(car.length));
+    key.push_back(static_cast<char>(car.direction));
+    key.push_back(static_cast<char>(car.lane));
+  }
+
+  return key;
+}
+
+std::uint64_t CompactBoard::getState() const noexcept {
+  std::uint64_t state = 0;
+
+  for (auto i = 0; i < this->car_count_; ++i) {
+    state = Layout::setPosition(state, i, this->cars_[i].position);
+  }
+
+  return state;
+}
+
+void CompactBoard::validate() const {
+  if (this->board_size_ == 0) {
+    throw std::invalid_argument("Board is empty");
+  }
+
+  // Every car lies on the board, on cells of its own
+  const int size = this->board_size_;
+  std::bitset<UINT8_MAX + 1> ids{};
+  std::uint64_t occupancy = 0;
+  for (auto i = 0; i < this->car_count_; ++i) {
+    const Car &car = this->cars_[i];
+    const std::string name = "Car " + std::to_string(car.id);
+    if (car.id == 0 || ids.test(car.id)) {
+      throw std::invalid_argument(name + " has a zero or repeated ID");
+    }
+    ids.set(car.id);
+    if (car.direction != ::Car::Horizontal &&
+        car.direction != ::Car::Vertical) {
+      throw std::invalid_argument(name + " has an invalid direction");
+    }
+    if (car.length == 0 || car.lane >= size ||
+        car.position + car.length > size) {
+      throw std::invalid_argument(name + " does not fit on the board");
+    }
+
+    const bool horizontal = car.direction == ::Car::Horizontal;
+    for (auto k = 0; k < car.length; ++k) {
+      const int cell = horizontal ? car.lane * size + car.position + k
+                                  : (car.position + k) * size + car.lane;
+      const auto bit = std::uint64_t{1} << cell;
+      if (occupancy & bit) {
+        throw std::invalid_argument(name + " overlaps another car");
+      }
+      occupancy |= bit;
+    }
+    if (car.id == this->main_id_ && !horizontal) {
+      throw std::invalid_argument("Main car is not horizontal");
+    }
+  }
+  if (!ids.test(this->main_id_)) {
+    throw std::invalid_argument("Board has no main car");
+  }
+}
+
+void CompactBoard::sortCars() noexcept {
+  // Horizontal lanes first, then vertical lanes, then by position in the lane
+  std::sort(this->cars_.begin(), this->cars_.begin() + this->car_count_,
+            [](const Car &lhs, const Car &rhs) {
+              return std::tie(lhs.direction, lhs.lane, lhs.position) <
+                     std::tie(rhs.direction, rhs.lane, rhs.position);
+            });
+}
@@ -0,0 +1,123 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "Board.h"
+#include "Layout.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// A board small enough for a Layout, held in a fixed-size value without any
+/// allocation: the board size, the main car's ID and the ID, length,
+/// direction, lane and lane position of every car.
+/// Cars are kept in the order of Layout, so the layout key and packed state
+/// of a compact board are read off directly, and boards of a large corpus
+/// can be grouped by layout without building a Board for each of them.
+/// </summary>
+class CompactBoard {
+ public:
+  struct Car {
+    std::uint8_t id;
+    std::uint8_t length;
+    std::uint8_t direction;
+    // The row of a horizontal car or the column of a vertical car
+    std::uint8_t lane;
+    // The column of a horizontal car or the top row of a vertical car
+    std::uint8_t position;
+  };
+
+  /// <summary>
+  /// Parse a square puzzle written as one character per cell, row by row.
+  /// 'o' or '.' is an empty cell, 'A' is the main car and every other
+  /// letter is another car, 'B' being ID 2. Throws std::invalid_argument if
+  /// the cells are not a valid board or the board is too large for a Layout.
+  /// </summary>
+  static CompactBoard parse(const char *cells, std::size_t count);
+
+  /// <summary>
+  /// A constructor for creating the compact form of a board. Throws
+  /// std::invalid_argument if the board is too large for a Layout, or a car
+  /// ID, length or position does not fit in a byte or on the board.
+  /// </summary>
+  explicit CompactBoard(const Board &board);
+
+  /// <summary>
+  /// A constructor for creating a compact board from its cars, in any order.
+  /// Throws std::invalid_argument if there are more cars than a Layout
+  /// holds or the cars are not a valid board.
+  /// </summary>
+  CompactBoard(int board_size, int main_id, const Car *cars, int car_count);
+
+  /// <summary>
+  /// Default constructor. The board holds no cars.
+  /// </summary>
+  CompactBoard() = default;
+
+  /// <summary>
+  /// Overloaded equality operator.
+  /// </summary>
+  friend bool operator==(const CompactBoard &lhs,
+                         const CompactBoard &rhs) noexcept {
+    return lhs.getLayoutKey() == rhs.getLayoutKey() &&
+           lhs.getState() == rhs.getState();
+  }
+
+  /// <summary>
+  /// Create the Board object of the compact board.
+  /// </summary>
+  Board toBoard() const;
+
+  /// <summary>
+  /// Create the key of the board's layout, equal to Layout::getKey.
+  /// </summary>
+  std::string getLayoutKey() const;
+
+  /// <summary>
+  /// Pack the car positions into a state, equal to Layout::encode.
+  /// </summary>
+  std::uint64_t getState() const noexcept;
+
+  /// <summary>
+  /// Default getter for board size.
+  /// </summary>
+  int getBoardSize() const noexcept { return this->board_size_; }
+
+  /// <summary>
+  /// Default getter for main car's ID.
+  /// </summary>
+  int getMainId() const noexcept { return this->main_id_; }
+
+  /// <summary>
+  /// Default getter for the number of cars.
+  /// </summary>
+  int getCarCount() const noexcept { return this->car_count_; }
+
+  /// <summary>
+  /// Default getter for a car in Layout order.
+  /// </summary>
+  const Car &getCar(int index) const noexcept { return this->cars_[index]; }
+
+ private:
+  /// <summary>
+  /// Check that the cars are a valid board: unique IDs, straight cars on
+  /// the board without overlaps and a horizontal main car. Throws
+  /// std::invalid_argument if they are not.
+  /// </summary>
+  void validate() const;
+
+  /// <summary>
+  /// Sort the cars into Layout order.
+  /// </summary>
+  void sortCars() noexcept;
+
+  std::uint8_t board_size_{0};
+  std::uint8_t main_id_{0};
+  std::uint8_t car_count_{0};
+  std::array<Car, Layout::kMaxCars> cars_{};
+};
@@ -1,12 +1,12 @@
-/**
- * Copyright 2019 Martin Pham
- */
-
-#pragma once
-
-#define BOARD_SIZE 6
-#define BOARD_MAX_CARS 11
-
-#define CAR_MAIN_ID 1
-#define CAR_MIN_LENGTH 2
-#define CAR_MAX_LENGTH 3
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#define BOARD_SIZE 6
+#define BOARD_MAX_CARS 11
+
+#define CAR_MAIN_ID 1
+#define CAR_MIN_LENGTH 2
+#define CAR_MAX_LENGTH 3
@@ -0,0 +1,156 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "CorpusReader.h"
+
+#include "MappedFile.h"
+#include "PuzzleCorpus.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+/// <summary>
+/// The puzzles of one chunk of the file, and the first error in it.
+/// </summary>
+struct Chunk {
+  const char *begin;
+  const char *end;
+  std::vector<CompactBoard> boards;
+  std::size_t lines{0};
+  // Line of the first error within the chunk, counted from 1
+  std::size_t error_line{0};
+  std::string error{};
+};
+
+bool isSpace(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void parseChunk(Chunk &chunk) {
+  for (const char *line = chunk.begin; line < chunk.end;) {
+    auto *newline = static_cast<const char *>(
+        std::memchr(line, '\n', static_cast<std::size_t>(chunk.end - line)));
+    const char *line_end = newline != nullptr ? newline : chunk.end;
+    ++chunk.lines;
+
+    // The cells are the first word of the line
+    const char *cells = line;
+    while (cells < line_end && isSpace(*cells)) {
+      ++cells;
+    }
+    const char *cells_end = cells;
+    while (cells_end < line_end && !isSpace(*cells_end)) {
+      ++cells_end;
+    }
+
+    if (cells != cells_end) {
+      try {
+        chunk.boards.emplace_back(CompactBoard::parse(
+            cells, static_cast<std::size_t>(cells_end - cells)));
+      } catch (const std::invalid_argument &e) {
+        chunk.error_line = chunk.lines;
+        chunk.error = e.what();
+        return;
+      }
+    }
+    line = line_end + 1;
+  }
+}
+}  // namespace
+
+std::vector<CompactBoard> CorpusReader::read(const std::string &path,
+                                             const Options &options) {
+  const MappedFile file{path};
+
+  // Packed corpora are decoded record by record, without any parsing
+  if (PuzzleCorpus::isCorpus(file)) {
+    const PuzzleCorpus corpus{path};
+    std::vector<CompactBoard> boards{};
+    boards.reserve(corpus.size());
+    for (const auto &record : corpus) {
+      boards.emplace_back(record.toCompactBoard());
+    }
+    return boards;
+  }
+
+  const auto *data = reinterpret_cast<const char *>(file.getData());
+  const char *end = data + file.getSize();
+
+  // Chunks end after a newline, so no line is split between two chunks
+  std::vector<Chunk> chunks{};
+  const std::size_t chunk_bytes = std::max<std::size_t>(options.chunk_bytes, 1);
+  for (const char *begin = data; begin < end;) {
+    const char *chunk_end =
+        end - begin > static_cast<std::ptrdiff_t>(chunk_bytes)
+            ? begin + chunk_bytes
+            : end;
+    if (chunk_end < end) {
+      auto *newline = static_cast<const char *>(std::memchr(
+          chunk_end, '\n', static_cast<std::size_t>(end - chunk_end)));
+      chunk_end = newline != nullptr ? newline + 1 : end;
+    }
+    chunks.emplace_back(Chunk{begin, chunk_end, {}});
+    begin = chunk_end;
+  }
+
+  // Threads take every n-th chunk
+  std::size_t threads = options.threads;
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min(threads, chunks.size());
+  std::vector<std::thread> workers{};
+  for (std::size_t t = 1; t < threads; ++t) {
+    workers.emplace_back([&chunks, threads, t] {
+      for (auto i = t; i < chunks.size(); i += threads) {
+        parseChunk(chunks[i]);
+      }
+    });
+  }
+  for (std::size_t i = 0; i < chunks.size(); i += threads) {
+    parseChunk(chunks[i]);
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+
+  std::size_t count = 0;
+  std::size_t lines = 0;
+  for (const auto &chunk : chunks) {
+    if (!chunk.error.empty()) {
+      throw std::invalid_argument(
+          path + ":" + std::to_string(lines + chunk.error_line) + ": " +
+          chunk.error);
+    }
+    count += chunk.boards.size();
+    lines += chunk.lines;
+  }
+
+  std::vector<CompactBoard> boards{};
+  boards.reserve(count);
+  for (const auto &chunk : chunks) {
+    boards.insert(boards.end(), chunk.boards.begin(), chunk.boards.end());
+  }
+  return boards;
+}
+
+std::vector<CompactBoard> CorpusReader::read(const std::string &path) {
+  return read(path, Options{});
+}
+
+std::size_t CorpusReader::load(const std::string &path, BatchSolver &solver,
+                               const Options &options) {
+  const auto boards = read(path, options);
+  for (const auto &board : boards) {
+    solver.add(board);
+  }
+  return boards.size();
+}
+
+std::size_t CorpusReader::load(const std::string &path, BatchSolver &solver) {
+  return load(path, solver, Options{});
+}
@@ -0,0 +1,56 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "BatchSolver.h"
+#include "CompactBoard.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// A reader for large puzzle corpora: one puzzle per line, written as one
+/// character per cell as in CompactBoard::parse, optionally followed by
+/// whitespace and anything else (such as the optimal number of moves).
+/// Blank lines are skipped. Packed corpora written by PuzzleCorpusWriter are
+/// read as well.
+/// The file is memory mapped and split on line boundaries into chunks,
+/// which are parsed in parallel straight into compact boards.
+/// </summary>
+class CorpusReader {
+ public:
+  struct Options {
+    /// <summary>
+    /// The number of parsing threads, 0 for one per hardware thread.
+    /// </summary>
+    std::size_t threads{0};
+
+    /// <summary>
+    /// The size of the chunks the file is split into, in bytes.
+    /// </summary>
+    std::size_t chunk_bytes{std::size_t{1} << 22};
+  };
+
+  /// <summary>
+  /// Parse every puzzle of a corpus file in file order. Throws
+  /// std::runtime_error if the file cannot be read, and std::invalid_argument
+  /// naming the line of the first puzzle that cannot be parsed.
+  /// </summary>
+  static std::vector<CompactBoard> read(const std::string &path,
+                                        const Options &options);
+
+  static std::vector<CompactBoard> read(const std::string &path);
+
+  /// <summary>
+  /// Parse every puzzle of a corpus file and queue it on a batch solver, in
+  /// file order.
+  /// </summary>
+  /// <returns>The number of puzzles queued.</returns>
+  static std::size_t load(const std::string &path, BatchSolver &solver,
+                          const Options &options);
+
+  static std::size_t load(const std::string &path, BatchSolver &solver);
+};
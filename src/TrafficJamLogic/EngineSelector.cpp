@@ -0,0 +1,282 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "EngineSelector.h"
+
+#include "BitmapSearch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+/// <summary>
+/// Replay stored moves from a board, checking each is a legal slide.
+/// </summary>
+/// <returns>The boards from the board to the last move, empty if a move is
+/// illegal or the last board is not solved.</returns>
+std::vector<std::shared_ptr<Board>> replay(
+    const Board &board, const SolutionStore::Solution &solution) {
+  Board::GenerationOptions generation{};
+  generation.slide = true;
+
+  std::vector<std::shared_ptr<Board>> path{std::make_shared<Board>(board)};
+  for (std::size_t i = 0; i < solution.size(); ++i) {
+    auto states = path.back()->getPossibleStates(generation);
+    auto next = std::find_if(states.begin(), states.end(),
+                             [&solution, i](const Board &s) {
+                               return s.getLastMove() == solution[i];
+                             });
+    if (next == states.end()) {
+      return {};
+    }
+    path.emplace_back(std::make_shared<Board>(std::move(*next)));
+  }
+
+  if (!path.back()->solved()) {
+    return {};
+  }
+  return path;
+}
+
+std::invalid_argument ruleError(int line, const std::string &message) {
+  return std::invalid_argument("Rule on line " + std::to_string(line) + ": " +
+                               message);
+}
+
+/// <summary>
+/// Parse a number of bytes with an optional K, M or G suffix.
+/// </summary>
+std::uint64_t parseBytes(const std::string &text) {
+  std::size_t end = 0;
+  auto bytes = std::stoull(text, &end);
+  const std::string suffix = text.substr(end);
+  if (suffix == "K") {
+    bytes <<= 10;
+  } else if (suffix == "M") {
+    bytes <<= 20;
+  } else if (suffix == "G") {
+    bytes <<= 30;
+  } else if (!suffix.empty()) {
+    throw std::invalid_argument("unknown size suffix " + suffix);
+  }
+  return bytes;
+}
+}  // namespace
+
+bool EngineSelector::Condition::holds(const Features &features) const {
+  const int feature = features.*(this->feature);
+  switch (this->op) {
+    case Op::Less:
+      return feature < this->value;
+    case Op::LessEqual:
+      return feature <= this->value;
+    case Op::Equal:
+      return feature == this->value;
+    case Op::GreaterEqual:
+      return feature >= this->value;
+    case Op::Greater:
+      return feature > this->value;
+  }
+  return false;
+}
+
+EngineSelector EngineSelector::parse(std::istream &rules) {
+  static const std::pair<const char *, int Features::*> kFeatures[] = {
+      {"cars", &Features::cars},
+      {"blockers", &Features::blockers},
+      {"free", &Features::free},
+      {"congestion", &Features::congestion},
+      {"h", &Features::h}};
+  // Longer operators first so that <= is not read as <
+  static const std::pair<const char *, Condition::Op> kOps[] = {
+      {"<=", Condition::Op::LessEqual},
+      {">=", Condition::Op::GreaterEqual},
+      {"==", Condition::Op::Equal},
+      {"<", Condition::Op::Less},
+      {">", Condition::Op::Greater}};
+  static const std::pair<const char *, Engine> kEngines[] = {
+      {"astar", Engine::AStar},
+      {"anytime", Engine::Anytime},
+      {"bitmap", Engine::Bitmap},
+      {"store", Engine::Store}};
+
+  EngineSelector selector{};
+  std::string line;
+  for (auto number = 1; std::getline(rules, line); ++number) {
+    line = line.substr(0, line.find('#'));
+    const auto arrow = line.find("->");
+    if (arrow == std::string::npos) {
+      if (line.find_first_not_of(" \t\r") != std::string::npos) {
+        throw ruleError(number, "missing ->");
+      }
+      continue;
+    }
+
+    Rule rule{};
+    rule.selection.rule = number;
+
+    std::istringstream conditions{line.substr(0, arrow)};
+    std::string token;
+    while (conditions >> token) {
+      auto op = std::find_if(
+          std::begin(kOps), std::end(kOps), [&token](const auto &o) {
+            return token.find(o.first) != std::string::npos;
+          });
+      if (op == std::end(kOps)) {
+        throw ruleError(number, "malformed condition " + token);
+      }
+      const auto at = token.find(op->first);
+      const auto name = token.substr(0, at);
+      auto feature = std::find_if(
+          std::begin(kFeatures), std::end(kFeatures),
+          [&name](const auto &f) { return name == f.first; });
+      if (feature == std::end(kFeatures)) {
+        throw ruleError(number, "unknown feature " + name);
+      }
+      try {
+        rule.conditions.emplace_back(
+            Condition{feature->second, op->second,
+                      std::stoi(token.substr(at + std::strlen(op->first)))});
+      } catch (const std::logic_error &) {
+        throw ruleError(number, "malformed condition " + token);
+      }
+    }
+
+    std::istringstream selection{line.substr(arrow + 2)};
+    if (!(selection >> token)) {
+      throw ruleError(number, "missing engine");
+    }
+    auto engine = std::find_if(
+        std::begin(kEngines), std::end(kEngines),
+        [&token](const auto &e) { return token == e.first; });
+    if (engine == std::end(kEngines)) {
+      throw ruleError(number, "unknown engine " + token);
+    }
+    rule.selection.engine = engine->second;
+
+    while (selection >> token) {
+      const auto equals = token.find('=');
+      const auto key = token.substr(0, equals);
+      const auto value =
+          equals == std::string::npos ? "" : token.substr(equals + 1);
+      if (key == "weight" || key == "memory") {
+        try {
+          if (key == "weight") {
+            rule.selection.options.weight = std::stod(value);
+          } else {
+            rule.selection.max_bytes = parseBytes(value);
+          }
+        } catch (const std::logic_error &) {
+          throw ruleError(number, "malformed parameter " + token);
+        }
+      } else if (key == "prune") {
+        rule.selection.options.generation.prune_transpositions = true;
+      } else if (key == "lazy") {
+        rule.selection.options.lazy_heuristic = true;
+      } else if (key == "slide") {
+        rule.selection.options.generation.slide = true;
+        rule.selection.options.cost = AStar::Options::Cost::Slides;
+      } else {
+        throw ruleError(number, "unknown parameter " + key);
+      }
+    }
+
+    selector.rules_.emplace_back(std::move(rule));
+  }
+
+  return selector;
+}
+
+EngineSelector EngineSelector::load(const std::string &path) {
+  std::ifstream rules{path};
+  if (!rules) {
+    throw std::runtime_error("Cannot open " + path);
+  }
+  return parse(rules);
+}
+
+EngineSelector::Features EngineSelector::getFeatures(const Board &board) {
+  const int size = board.getBoardSize();
+  const Car &main_car = board.getMainCar();
+
+  Features features{static_cast<int>(board.getCars().size()), 0, 0, 0,
+                    AStar::calculateHValue(board)};
+
+  std::unordered_set<int> blockers{};
+  for (auto col = main_car.getPosCol() + main_car.getLength(); col < size;
+       ++col) {
+    const int id = board.getGameBoardAt(main_car.getPosRow(), col);
+    if (id != 0) {
+      blockers.insert(id);
+    }
+  }
+  features.blockers = static_cast<int>(blockers.size());
+
+  for (auto i = 0; i < size; ++i) {
+    int row = 0;
+    int col = 0;
+    for (auto j = 0; j < size; ++j) {
+      row += board.getGameBoardAt(i, j) != 0;
+      col += board.getGameBoardAt(j, i) != 0;
+    }
+    features.free += size - row;
+    features.congestion = std::max({features.congestion, row, col});
+  }
+
+  return features;
+}
+
+EngineSelector::Selection EngineSelector::select(const Board &board) const {
+  return this->select(getFeatures(board));
+}
+
+EngineSelector::Selection EngineSelector::select(
+    const Features &features) const {
+  for (const auto &rule : this->rules_) {
+    if (std::all_of(
+            rule.conditions.begin(), rule.conditions.end(),
+            [&features](const Condition &c) { return c.holds(features); })) {
+      return rule.selection;
+    }
+  }
+  return Selection{};
+}
+
+std::vector<std::shared_ptr<Board>> EngineSelector::solve(
+    const Board &board, const SolutionStore *store) const {
+  const auto selection = this->select(board);
+
+  switch (selection.engine) {
+    case Engine::Anytime:
+      return AStar::anytimeSearch(board, selection.options);
+    case Engine::Bitmap:
+      try {
+        return BitmapSearch::search(board, selection.max_bytes);
+      } catch (const std::length_error &) {
+      } catch (const std::invalid_argument &) {
+        // Boards too large for a Layout
+      }
+      break;
+    case Engine::Store: {
+      SolutionStore::Solution solution{};
+      // A stale or corrupt entry is searched for instead
+      if (store != nullptr && store->find(board, solution)) {
+        auto path = replay(board, solution);
+        if (!path.empty()) {
+          return path;
+        }
+      }
+      break;
+    }
+    case Engine::AStar:
+      break;
+  }
+
+  return AStar::search(board, selection.options);
+}
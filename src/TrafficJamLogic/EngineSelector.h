@@ -0,0 +1,148 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "AStar.h"
+#include "Board.h"
+#include "SolutionStore.h"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Picks the engine and its parameters for a board from cheap features of
+/// the board, following rules loaded from a config file.
+/// Each line of the config holds one rule: conditions on features, an arrow,
+/// then the engine and its parameters. The first rule whose conditions all
+/// hold is used, a rule without conditions always holds. For example:
+///   # feature conditions -> engine parameters
+///   h<=2 -> astar
+///   cars>=10 blockers>=2 -> astar weight=1.5 prune
+///   -> bitmap memory=256M
+/// Features are cars, blockers, free, congestion and h (see Features).
+/// Engines are astar, anytime, bitmap and store. Parameters are weight=W,
+/// prune, lazy, slide and memory=N with an optional K, M or G suffix. The A*
+/// parameters of a bitmap or store rule apply to its A* fallback.
+/// </summary>
+class EngineSelector {
+ public:
+  struct Features {
+    /// <summary>
+    /// The number of cars.
+    /// </summary>
+    int cars;
+    /// <summary>
+    /// The number of cars in the main car's row ahead of it.
+    /// </summary>
+    int blockers;
+    /// <summary>
+    /// The number of empty cells.
+    /// </summary>
+    int free;
+    /// <summary>
+    /// The most occupied cells in any row or column.
+    /// </summary>
+    int congestion;
+    /// <summary>
+    /// The value of AStar::calculateHValue.
+    /// </summary>
+    int h;
+  };
+
+  enum class Engine {
+    /// <summary>
+    /// AStar::search.
+    /// </summary>
+    AStar,
+    /// <summary>
+    /// AStar::anytimeSearch.
+    /// </summary>
+    Anytime,
+    /// <summary>
+    /// BitmapSearch::search, falling back to AStar::search when the board
+    /// needs more than the memory budget.
+    /// </summary>
+    Bitmap,
+    /// <summary>
+    /// A lookup in a SolutionStore, falling back to AStar::search when the
+    /// board is not stored or its stored moves do not solve it.
+    /// </summary>
+    Store
+  };
+
+  struct Selection {
+    Engine engine{Engine::AStar};
+    AStar::Options options{};
+    /// <summary>
+    /// The memory budget of the engine in bytes.
+    /// </summary>
+    std::uint64_t max_bytes{std::uint64_t{1} << 30};
+    /// <summary>
+    /// The line of the rule that selected the engine, 0 for the default.
+    /// </summary>
+    int rule{0};
+  };
+
+  /// <summary>
+  /// A constructor for creating a selector that always picks AStar::search.
+  /// </summary>
+  EngineSelector() = default;
+
+  /// <summary>
+  /// Read rules from a stream. Throws std::invalid_argument with the line
+  /// number of a malformed rule.
+  /// </summary>
+  static EngineSelector parse(std::istream &rules);
+
+  /// <summary>
+  /// Read rules from a config file. Throws std::runtime_error if the file
+  /// cannot be opened.
+  /// </summary>
+  static EngineSelector load(const std::string &path);
+
+  /// <summary>
+  /// Compute the features of a board.
+  /// </summary>
+  static Features getFeatures(const Board &board);
+
+  /// <summary>
+  /// Pick the engine for a board.
+  /// </summary>
+  Selection select(const Board &board) const;
+
+  /// <summary>
+  /// Pick the engine for a board with the given features.
+  /// </summary>
+  Selection select(const Features &features) const;
+
+  /// <summary>
+  /// Solve a board with the engine picked for it.
+  /// </summary>
+  /// <param name="store">The store used by the store engine, may be
+  /// null.</param>
+  std::vector<std::shared_ptr<Board>> solve(
+      const Board &board, const SolutionStore *store = nullptr) const;
+
+ private:
+  struct Condition {
+    enum class Op { Less, LessEqual, Equal, GreaterEqual, Greater };
+
+    int Features::*feature;
+    Op op;
+    int value;
+
+    bool holds(const Features &features) const;
+  };
+
+  struct Rule {
+    std::vector<Condition> conditions;
+    Selection selection;
+  };
+
+  std::vector<Rule> rules_;
+};
@@ -0,0 +1,356 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "ExternalSearch.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+/// <summary>
+/// A directory of its own for the files of one search, removed with every
+/// file in it when the search returns or throws.
+/// </summary>
+class SearchDirectory {
+ public:
+  explicit SearchDirectory(const std::string &parent) {
+    std::random_device random{};
+    std::error_code error{};
+    for (auto attempt = 0; attempt < 16; ++attempt) {
+      auto path = std::filesystem::path(parent) /
+                  ("traffic-jam-" + std::to_string(random()));
+      if (std::filesystem::create_directory(path, error)) {
+        this->path_ = path.string();
+        return;
+      }
+    }
+    throw std::runtime_error("Cannot create a directory in " + parent);
+  }
+
+  ~SearchDirectory() {
+    std::error_code error{};
+    std::filesystem::remove_all(this->path_, error);
+  }
+
+  SearchDirectory(const SearchDirectory &) = delete;
+  SearchDirectory &operator=(const SearchDirectory &) = delete;
+
+  const std::string &getPath() const noexcept { return this->path_; }
+
+ private:
+  std::string path_;
+};
+
+/// <summary>
+/// A sequential reader of a file of sorted packed states.
+/// An empty path reads as an empty file.
+/// </summary>
+class StateReader {
+ public:
+  StateReader(const std::string &path, std::size_t buffer_bytes)
+      : path_{path},
+        file_{path.empty() ? nullptr : std::fopen(path.c_str(), "rb")},
+        buffer_(std::max<std::size_t>(buffer_bytes / sizeof(std::uint64_t),
+                                      1)) {
+    if (!path.empty() && this->file_ == nullptr) {
+      throw std::runtime_error("Cannot read " + path);
+    }
+    this->fill();
+  }
+
+  ~StateReader() {
+    if (this->file_ != nullptr) {
+      std::fclose(this->file_);
+    }
+  }
+
+  StateReader(const StateReader &) = delete;
+  StateReader &operator=(const StateReader &) = delete;
+
+  bool done() const noexcept { return this->position_ == this->size_; }
+
+  std::uint64_t peek() const noexcept { return this->buffer_[this->position_]; }
+
+  void next() {
+    if (++this->position_ == this->size_) {
+      this->fill();
+    }
+  }
+
+  /// <summary>
+  /// Skip states smaller than a state.
+  /// </summary>
+  /// <returns>True if the state is in the file.</returns>
+  bool contains(std::uint64_t state) {
+    while (!this->done() && this->peek() < state) {
+      this->next();
+    }
+    return !this->done() && this->peek() == state;
+  }
+
+ private:
+  void fill() {
+    this->position_ = 0;
+    if (this->file_ == nullptr) {
+      this->size_ = 0;
+      return;
+    }
+    // A short read is the end of the file only if no error occurred
+    this->size_ = std::fread(this->buffer_.data(), sizeof(std::uint64_t),
+                             this->buffer_.size(), this->file_);
+    if (this->size_ < this->buffer_.size() && std::ferror(this->file_)) {
+      throw std::runtime_error("Cannot read " + this->path_);
+    }
+  }
+
+  std::string path_;
+  std::FILE *file_;
+  std::vector<std::uint64_t> buffer_;
+  std::size_t position_{0};
+  std::size_t size_{0};
+};
+
+/// <summary>
+/// A sequential writer of packed states.
+/// </summary>
+class StateWriter {
+ public:
+  StateWriter(const std::string &path, std::size_t buffer_bytes)
+      : path_{path}, file_{std::fopen(path.c_str(), "wb")} {
+    if (this->file_ == nullptr) {
+      throw std::runtime_error("Cannot write " + path);
+    }
+    this->buffer_.reserve(
+        std::max<std::size_t>(buffer_bytes / sizeof(std::uint64_t), 1));
+  }
+
+  ~StateWriter() {
+    // Errors are reported by write(), the last block is checked by close()
+    if (this->file_ != nullptr) {
+      this->flush();
+      std::fclose(this->file_);
+    }
+  }
+
+  StateWriter(const StateWriter &) = delete;
+  StateWriter &operator=(const StateWriter &) = delete;
+
+  void write(std::uint64_t state) {
+    this->buffer_.emplace_back(state);
+    ++this->count_;
+    if (this->buffer_.size() == this->buffer_.capacity() && !this->flush()) {
+      throw std::runtime_error("Cannot write " + this->path_);
+    }
+  }
+
+  void close() {
+    bool flushed = this->flush();
+    bool closed = std::fclose(this->file_) == 0;
+    this->file_ = nullptr;
+    if (!flushed || !closed) {
+      throw std::runtime_error("Cannot write " + this->path_);
+    }
+  }
+
+  std::uint64_t getCount() const noexcept { return this->count_; }
+
+ private:
+  bool flush() {
+    auto written = std::fwrite(this->buffer_.data(), sizeof(std::uint64_t),
+                               this->buffer_.size(), this->file_);
+    bool complete = written == this->buffer_.size();
+    this->buffer_.clear();
+    return complete;
+  }
+
+  std::string path_;
+  std::FILE *file_;
+  std::vector<std::uint64_t> buffer_;
+  std::uint64_t count_{0};
+};
+
+std::string getLayerPath(const ExternalSearch::Options &options, int depth) {
+  return options.directory + "/layer-" + std::to_string(depth) + ".bin";
+}
+
+std::string getRunPath(const ExternalSearch::Options &options, std::size_t run) {
+  return options.directory + "/run-" + std::to_string(run) + ".bin";
+}
+
+/// <summary>
+/// Sort the successors of a layer into run files.
+/// </summary>
+/// <returns>The number of runs written.</returns>
+std::size_t writeRuns(const Layout &layout,
+                      const ExternalSearch::Options &options, int depth) {
+  std::vector<std::uint64_t> buffer{};
+  buffer.reserve(options.run_states + 2 * Layout::kMaxCars);
+  std::size_t runs = 0;
+
+  auto write_run = [&]() {
+    std::sort(buffer.begin(), buffer.end());
+    buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+    StateWriter run{getRunPath(options, runs++), options.io_buffer_bytes};
+    for (const auto &state : buffer) {
+      run.write(state);
+    }
+    run.close();
+    buffer.clear();
+  };
+
+  StateReader layer{getLayerPath(options, depth), options.io_buffer_bytes};
+  for (; !layer.done(); layer.next()) {
+    layout.getSuccessors(layer.peek(), buffer);
+    if (buffer.size() >= options.run_states) {
+      write_run();
+    }
+  }
+  if (!buffer.empty()) {
+    write_run();
+  }
+
+  return runs;
+}
+
+/// <summary>
+/// Merge the runs of a layer into the next layer, dropping duplicates and
+/// states of the two previous layers.
+/// </summary>
+/// <returns>The number of states in the next layer and a solved state if one
+/// was found.</returns>
+std::pair<std::uint64_t, std::uint64_t> mergeRuns(
+    const Layout &layout, const ExternalSearch::Options &options, int depth,
+    std::size_t runs, bool &found) {
+  std::vector<std::unique_ptr<StateReader>> readers{};
+  for (std::size_t r = 0; r < runs; ++r) {
+    readers.emplace_back(std::make_unique<StateReader>(
+        getRunPath(options, r), options.io_buffer_bytes));
+  }
+
+  // Smallest state first, with the index of its run
+  using Entry = std::pair<std::uint64_t, std::size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heads{};
+  for (std::size_t r = 0; r < runs; ++r) {
+    if (!readers[r]->done()) {
+      heads.emplace(readers[r]->peek(), r);
+    }
+  }
+
+  StateReader current{getLayerPath(options, depth), options.io_buffer_bytes};
+  StateReader previous{depth > 0 ? getLayerPath(options, depth - 1) : "",
+                       options.io_buffer_bytes};
+  std::uint64_t goal = 0;
+  std::uint64_t count = 0;
+
+  {
+    StateWriter next{getLayerPath(options, depth + 1), options.io_buffer_bytes};
+    bool has_last = false;
+    std::uint64_t last = 0;
+
+    while (!heads.empty()) {
+      auto head = heads.top();
+      heads.pop();
+      auto &reader = *readers[head.second];
+      reader.next();
+      if (!reader.done()) {
+        heads.emplace(reader.peek(), head.second);
+      }
+
+      if ((has_last && head.first == last) || current.contains(head.first) ||
+          previous.contains(head.first)) {
+        continue;
+      }
+      has_last = true;
+      last = head.first;
+      next.write(head.first);
+
+      if (!found && layout.solved(head.first)) {
+        found = true;
+        goal = head.first;
+      }
+    }
+    count = next.getCount();
+    next.close();
+  }
+
+  readers.clear();
+  for (std::size_t r = 0; r < runs; ++r) {
+    std::remove(getRunPath(options, r).c_str());
+  }
+
+  return {count, goal};
+}
+
+/// <summary>
+/// Find a neighbour of a state in a layer file.
+/// </summary>
+std::uint64_t findNeighbour(const Layout &layout,
+                            const ExternalSearch::Options &options, int depth,
+                            std::uint64_t state) {
+  std::vector<std::uint64_t> successors{};
+  layout.getSuccessors(state, successors);
+  std::sort(successors.begin(), successors.end());
+
+  StateReader layer{getLayerPath(options, depth), options.io_buffer_bytes};
+  for (const auto &s : successors) {
+    if (layer.contains(s)) {
+      return s;
+    }
+  }
+
+  throw std::runtime_error("Layer file " + getLayerPath(options, depth) +
+                           " is incomplete");
+}
+}  // namespace
+
+ExternalSearch::Result ExternalSearch::search(const Board &board,
+                                              const Options &search_options) {
+  const Layout layout{board};
+  const SearchDirectory directory{search_options.directory};
+  Options options = search_options;
+  options.directory = directory.getPath();
+  Result result{};
+  auto start = layout.encode(board);
+  auto goal = start;
+  bool found = layout.solved(start);
+  auto depth = 0;
+
+  {
+    StateWriter layer{getLayerPath(options, 0), options.io_buffer_bytes};
+    layer.write(start);
+    layer.close();
+  }
+  result.layer_sizes.emplace_back(1);
+
+  while (!found && result.layer_sizes.back() > 0) {
+    auto runs = writeRuns(layout, options, depth);
+    auto merged = mergeRuns(layout, options, depth, runs, found);
+    ++depth;
+    if (merged.first > 0) {
+      result.layer_sizes.emplace_back(merged.first);
+    } else {
+      break;
+    }
+    goal = merged.second;
+  }
+
+  if (found) {
+    // Walk back from the goal through one neighbour in each earlier layer
+    std::vector<std::uint64_t> states{goal};
+    for (auto d = depth - 1; d >= 0; --d) {
+      states.emplace_back(findNeighbour(layout, options, d, states.back()));
+    }
+    for (auto it = states.rbegin(); it != states.rend(); ++it) {
+      result.path.emplace_back(std::make_shared<Board>(layout.decode(*it)));
+    }
+  }
+
+  return result;
+}
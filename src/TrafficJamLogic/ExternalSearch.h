@@ -0,0 +1,59 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "Board.h"
+#include "Layout.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ExternalSearch {
+struct Options {
+  /// <summary>
+  /// The directory in which every search creates a directory of its own for
+  /// its layer and run files. The search removes it when it returns or
+  /// throws.
+  /// </summary>
+  std::string directory{"."};
+
+  /// <summary>
+  /// The number of successors collected in memory before they are sorted
+  /// and written to a run file.
+  /// </summary>
+  std::size_t run_states{std::size_t{1} << 22};
+
+  /// <summary>
+  /// The buffer size of every file read or written, in bytes.
+  /// </summary>
+  std::size_t io_buffer_bytes{std::size_t{1} << 20};
+};
+
+struct Result {
+  /// <summary>
+  /// The boards from the start to the solved board, empty if the board cannot
+  /// be solved.
+  /// </summary>
+  std::vector<std::shared_ptr<Board>> path;
+
+  /// <summary>
+  /// The number of new states found at every depth. If the board cannot be
+  /// solved this covers the whole reachable state space.
+  /// </summary>
+  std::vector<std::uint64_t> layer_sizes;
+};
+
+/// <summary>
+/// A breadth-first search for the shortest solution to the board puzzle that
+/// keeps its layers on disk instead of in memory.
+/// Successors of a layer are sorted in bounded runs of packed states, then a
+/// k-way merge of the runs drops duplicates and every state found in the two
+/// previous layers, which are the only layers a move can lead back to.
+/// Throws std::runtime_error if a file cannot be written or read.
+/// </summary>
+Result search(const Board &board, const Options &options = Options{});
+}  // namespace ExternalSearch
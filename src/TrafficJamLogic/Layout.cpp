@@ -0,0 +1,263 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "Layout.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+int getLanePosition(const Car &car) {
+  return car.getDirection() == Car::Direction::Horizontal
+             ? car.getPosCol()
+             : car.getPosRow() + 1 - car.getLength();
+}
+}  // namespace
+
+Layout::Layout(const Board &board)
+    : board_size_{board.getBoardSize()}, main_id_{board.getMainId()} {
+  const auto &cars = board.getCars();
+
+  if (this->board_size_ > kMaxBoardSize ||
+      cars.size() > static_cast<std::size_t>(kMaxCars)) {
+    throw std::invalid_argument("Board is too large for a packed layout");
+  }
+
+  // Horizontal lanes first, then vertical lanes, then by position in the lane
+  std::vector<Car> sorted{};
+  for (const auto &c : cars) {
+    sorted.emplace_back(c.second);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const Car &lhs, const Car &rhs) {
+    auto lhs_lane = lhs.getDirection() == Car::Direction::Horizontal
+                        ? lhs.getPosRow()
+                        : lhs.getPosCol();
+    auto rhs_lane = rhs.getDirection() == Car::Direction::Horizontal
+                        ? rhs.getPosRow()
+                        : rhs.getPosCol();
+    return std::make_tuple(lhs.getDirection(), lhs_lane, getLanePosition(lhs)) <
+           std::make_tuple(rhs.getDirection(), rhs_lane, getLanePosition(rhs));
+  });
+
+  this->masks_.assign(sorted.size() * kMaxBoardSize, 0);
+
+  for (std::size_t i = 0; i < sorted.size(); ++i) {
+    const Car &car = sorted[i];
+    const bool horizontal = car.getDirection() == Car::Direction::Horizontal;
+    const int lane = horizontal ? car.getPosRow() : car.getPosCol();
+
+    if (car.getId() == this->main_id_) {
+      this->main_index_ = static_cast<int>(i);
+    }
+    this->ids_.emplace_back(car.getId());
+    this->lengths_.emplace_back(car.getLength());
+    this->directions_.emplace_back(car.getDirection());
+    this->lanes_.emplace_back(lane);
+
+    for (auto p = 0; p + car.getLength() <= this->board_size_; ++p) {
+      std::uint64_t mask = 0;
+      for (auto k = 0; k < car.getLength(); ++k) {
+        auto row = horizontal ? lane : p + k;
+        auto col = horizontal ? p + k : lane;
+        mask |= std::uint64_t{1} << (row * this->board_size_ + col);
+      }
+      this->masks_[i * kMaxBoardSize + p] = mask;
+    }
+  }
+}
+
+std::string Layout::getKey() const {
+  std::string key{static_cast<char>(this->board_size_),
+                  static_cast<char>(this->main_id_)};
+
+  for (std::size_t i = 0; i < this->ids_.size(); ++i) {
+    key.append(reinterpret_cast<const char *>(&this->ids_[i]), sizeof(int));
+    key.push_back(static_cast<char>(this->lengths_[i]));
+    key.push_back(static_cast<char>(this->directions_[i]));
+    key.push_back(static_cast<char>(this->lanes_[i]));
+  }
+
+  return key;
+}
+
+std::uint64_t Layout::encode(const Board &board) const {
+  std::uint64_t state = 0;
+
+  for (std::size_t i = 0; i < this->ids_.size(); ++i) {
+    state = setPosition(state, static_cast<int>(i),
+                        getLanePosition(board.getCar(this->ids_[i])));
+  }
+
+  return state;
+}
+
+Board Layout::decode(std::uint64_t state) const {
+  std::unordered_map<int, Car> cars{};
+
+  for (std::size_t i = 0; i < this->ids_.size(); ++i) {
+    auto position = getPosition(state, static_cast<int>(i));
+    if (this->directions_[i] == Car::Direction::Horizontal) {
+      cars.emplace(this->ids_[i], Car{this->ids_[i], this->lanes_[i], position,
+                                      this->lengths_[i], this->directions_[i]});
+    } else {
+      cars.emplace(this->ids_[i],
+                   Car{this->ids_[i], position + this->lengths_[i] - 1,
+                       this->lanes_[i], this->lengths_[i],
+                       this->directions_[i]});
+    }
+  }
+
+  return Board{std::move(cars), this->board_size_, this->main_id_};
+}
+
+std::uint64_t Layout::getOccupancy(std::uint64_t state) const noexcept {
+  std::uint64_t occupancy = 0;
+
+  for (auto i = 0; i < this->getCarCount(); ++i) {
+    occupancy |= this->getCarMask(i, getPosition(state, i));
+  }
+
+  return occupancy;
+}
+
+void Layout::getSuccessors(std::uint64_t state,
+                           std::vector<std::uint64_t> &successors) const {
+  const auto occupancy = this->getOccupancy(state);
+
+  for (auto i = 0; i < this->getCarCount(); ++i) {
+    auto position = getPosition(state, i);
+    auto mask = this->getCarMask(i, position);
+
+    // A step is legal if the cell the car moves into is free
+    if (position > 0 &&
+        !(this->getCarMask(i, position - 1) & ~mask & occupancy)) {
+      successors.emplace_back(setPosition(state, i, position - 1));
+    }
+    if (position + this->lengths_[i] < this->board_size_ &&
+        !(this->getCarMask(i, position + 1) & ~mask & occupancy)) {
+      successors.emplace_back(setPosition(state, i, position + 1));
+    }
+  }
+}
+
+void Layout::getSuccessors(const std::uint64_t *states, std::size_t count,
+                           std::vector<std::uint64_t> &successors) const {
+  std::size_t k = 0;
+
+#if defined(__AVX2__)
+  // A car's cells at position p are its cells at position 0 shifted by p
+  // steps of its lane: 1 cell for a horizontal car, a row for a vertical car
+  const int cars = this->getCarCount();
+  std::uint64_t bases[kMaxCars];
+  std::uint64_t strides[kMaxCars];
+  std::uint64_t limits[kMaxCars];
+  for (auto i = 0; i < cars; ++i) {
+    bases[i] = this->getCarMask(i, 0);
+    strides[i] = this->directions_[i] == Car::Direction::Horizontal
+                     ? 1
+                     : static_cast<std::uint64_t>(this->board_size_);
+    limits[i] =
+        static_cast<std::uint64_t>(this->board_size_ - this->lengths_[i]);
+  }
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i nibble = _mm256_set1_epi64x(0xF);
+  __m256i masks[kMaxCars];
+  __m256i positions[kMaxCars];
+  int back[kMaxCars];
+  int forward[kMaxCars];
+
+  for (; k + 4 <= count; k += 4) {
+    // Structure of arrays: the position of one car in all four states
+    const __m256i state =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(states + k));
+    __m256i occupancy = zero;
+    for (auto i = 0; i < cars; ++i) {
+      positions[i] = _mm256_and_si256(
+          _mm256_srl_epi64(state, _mm_cvtsi32_si128(4 * i)), nibble);
+      const __m256i shift = _mm256_mul_epu32(
+          positions[i],
+          _mm256_set1_epi64x(static_cast<long long>(strides[i])));
+      masks[i] = _mm256_sllv_epi64(
+          _mm256_set1_epi64x(static_cast<long long>(bases[i])), shift);
+      occupancy = _mm256_or_si256(occupancy, masks[i]);
+    }
+
+    // A step is legal if the car is not at the end of its lane and the cell
+    // it moves into is free
+    for (auto i = 0; i < cars; ++i) {
+      const __m128i stride =
+          _mm_cvtsi64_si128(static_cast<long long>(strides[i]));
+      const __m256i others = _mm256_andnot_si256(masks[i], occupancy);
+
+      const __m256i can_back = _mm256_cmpgt_epi64(positions[i], zero);
+      const __m256i back_free = _mm256_cmpeq_epi64(
+          _mm256_and_si256(_mm256_srl_epi64(masks[i], stride), others), zero);
+      back[i] = _mm256_movemask_pd(
+          _mm256_castsi256_pd(_mm256_and_si256(can_back, back_free)));
+
+      const __m256i can_forward = _mm256_cmpgt_epi64(
+          _mm256_set1_epi64x(static_cast<long long>(limits[i])), positions[i]);
+      const __m256i forward_free = _mm256_cmpeq_epi64(
+          _mm256_and_si256(_mm256_sll_epi64(masks[i], stride), others), zero);
+      forward[i] = _mm256_movemask_pd(
+          _mm256_castsi256_pd(_mm256_and_si256(can_forward, forward_free)));
+    }
+
+    // Every car can make at most two steps, write the successors without
+    // checking the capacity for each of them
+    const auto size = successors.size();
+    successors.resize(size + 8 * static_cast<std::size_t>(cars));
+    auto *out = successors.data() + size;
+    for (auto lane = 0; lane < 4; ++lane) {
+      const auto s = states[k + lane];
+      for (auto i = 0; i < cars; ++i) {
+        const auto step = std::uint64_t{1} << (4 * i);
+        *out = s - step;
+        out += back[i] >> lane & 1;
+        *out = s + step;
+        out += forward[i] >> lane & 1;
+      }
+    }
+    successors.resize(static_cast<std::size_t>(out - successors.data()));
+  }
+#endif
+
+  for (; k < count; ++k) {
+    this->getSuccessors(states[k], successors);
+  }
+}
+
+int Layout::getCarCount() const noexcept {
+  return static_cast<int>(this->ids_.size());
+}
+
+int Layout::getBoardSize() const noexcept { return this->board_size_; }
+
+int Layout::getMainId() const noexcept { return this->main_id_; }
+
+int Layout::getMainIndex() const noexcept { return this->main_index_; }
+
+int Layout::getId(int index) const noexcept { return this->ids_[index]; }
+
+int Layout::getLength(int index) const noexcept {
+  return this->lengths_[index];
+}
+
+Car::Direction Layout::getDirection(int index) const noexcept {
+  return this->directions_[index];
+}
+
+int Layout::getLane(int index) const noexcept { return this->lanes_[index]; }
+
+int Layout::getIndex(int id) const noexcept {
+  auto it = std::find(this->ids_.begin(), this->ids_.end(), id);
+  return it == this->ids_.end() ? -1
+                                : static_cast<int>(it - this->ids_.begin());
+}
@@ -0,0 +1,201 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "Board.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// The fixed part of a board: its size and the ID, length, direction and lane
+/// of every car. A state of the layout only holds the position of each car
+/// along its lane, packed into a 64-bit integer with 4 bits per car.
+/// Cars are ordered by lane and by position within the lane, so cars sharing
+/// a lane are next to each other and never change order.
+/// </summary>
+class Layout {
+ public:
+  /// <summary>
+  /// The largest board size supported, so that a board fits in a 64-bit
+  /// occupancy mask.
+  /// </summary>
+  static constexpr int kMaxBoardSize = 8;
+
+  /// <summary>
+  /// The largest number of cars supported, so that a state fits in 64 bits.
+  /// </summary>
+  static constexpr int kMaxCars = 16;
+
+  /// <summary>
+  /// A constructor for creating the layout of a board.
+  /// Throws std::invalid_argument if the board is larger than kMaxBoardSize or
+  /// has more than kMaxCars cars.
+  /// </summary>
+  /// <param name="board">A Board object whose cars define the layout.</param>
+  explicit Layout(const Board &board);
+
+  /// <summary>
+  /// Default constructor.
+  /// </summary>
+  Layout() = default;
+
+  /// <summary>
+  /// Default destructor.
+  /// </summary>
+  ~Layout() = default;
+
+  /// <summary>
+  /// Overloaded equality operator. Layouts are equal if their boards have the
+  /// same size, main ID and cars in the same lanes.
+  /// </summary>
+  friend bool operator==(const Layout &lhs, const Layout &rhs) noexcept {
+    return lhs.board_size_ == rhs.board_size_ &&
+           lhs.main_id_ == rhs.main_id_ && lhs.ids_ == rhs.ids_ &&
+           lhs.lengths_ == rhs.lengths_ &&
+           lhs.directions_ == rhs.directions_ && lhs.lanes_ == rhs.lanes_;
+  }
+
+  /// <summary>
+  /// Create a key identifying the layout, equal for equal layouts.
+  /// </summary>
+  std::string getKey() const;
+
+  /// <summary>
+  /// Pack the car positions of a board into a state.
+  /// Throws std::out_of_range if the board has a car missing from the layout.
+  /// </summary>
+  std::uint64_t encode(const Board &board) const;
+
+  /// <summary>
+  /// Unpack a state into a Board object.
+  /// </summary>
+  Board decode(std::uint64_t state) const;
+
+  /// <summary>
+  /// Get the position of a car along its lane: the column of a horizontal
+  /// car or the top row of a vertical car.
+  /// </summary>
+  /// <param name="state">A packed state.</param>
+  /// <param name="index">The car's index in the layout.</param>
+  static int getPosition(std::uint64_t state, int index) noexcept {
+    return static_cast<int>((state >> (4 * index)) & 0xF);
+  }
+
+  /// <summary>
+  /// Set the position of a car along its lane.
+  /// </summary>
+  /// <returns>The state with the car moved.</returns>
+  static std::uint64_t setPosition(std::uint64_t state, int index,
+                                   int position) noexcept {
+    return (state & ~(std::uint64_t{0xF} << (4 * index))) |
+           (static_cast<std::uint64_t>(position) << (4 * index));
+  }
+
+  /// <summary>
+  /// Get the cells covered by all cars, one bit per cell in row-major order.
+  /// </summary>
+  std::uint64_t getOccupancy(std::uint64_t state) const noexcept;
+
+  /// <summary>
+  /// Get the cells covered by a car at a position.
+  /// </summary>
+  std::uint64_t getCarMask(int index, int position) const noexcept {
+    return this->masks_[static_cast<std::size_t>(index) * kMaxBoardSize +
+                        position];
+  }
+
+  /// <summary>
+  /// Check if a state is solved for the main car.
+  /// </summary>
+  bool solved(std::uint64_t state) const noexcept {
+    return getPosition(state, this->main_index_) +
+               this->lengths_[this->main_index_] ==
+           this->board_size_;
+  }
+
+  /// <summary>
+  /// Append every state one car step away from a state.
+  /// </summary>
+  /// <param name="state">A packed state.</param>
+  /// <param name="successors">An array/vector the new states are appended
+  /// to.</param>
+  void getSuccessors(std::uint64_t state,
+                     std::vector<std::uint64_t> &successors) const;
+
+  /// <summary>
+  /// Append every state one car step away from each of a batch of states, in
+  /// the order of the states and with the successors of each state in the
+  /// order of getSuccessors.
+  /// With AVX2, four states are expanded at once, one state per 64-bit lane:
+  /// the position of a car in all four states is extracted in one vector and
+  /// the legality of every step is tested with lane-parallel mask operations.
+  /// </summary>
+  /// <param name="states">An array of packed states.</param>
+  /// <param name="count">The number of states.</param>
+  /// <param name="successors">An array/vector the new states are appended
+  /// to.</param>
+  void getSuccessors(const std::uint64_t *states, std::size_t count,
+                     std::vector<std::uint64_t> &successors) const;
+
+  /// <summary>
+  /// Default getter for the number of cars.
+  /// </summary>
+  int getCarCount() const noexcept;
+
+  /// <summary>
+  /// Default getter for board size.
+  /// </summary>
+  int getBoardSize() const noexcept;
+
+  /// <summary>
+  /// Default getter for main car's ID.
+  /// </summary>
+  int getMainId() const noexcept;
+
+  /// <summary>
+  /// Default getter for the main car's index in the layout.
+  /// </summary>
+  int getMainIndex() const noexcept;
+
+  /// <summary>
+  /// Default getter for a car's ID.
+  /// </summary>
+  int getId(int index) const noexcept;
+
+  /// <summary>
+  /// Default getter for a car's length.
+  /// </summary>
+  int getLength(int index) const noexcept;
+
+  /// <summary>
+  /// Default getter for a car's direction.
+  /// </summary>
+  Car::Direction getDirection(int index) const noexcept;
+
+  /// <summary>
+  /// Default getter for a car's lane: the row of a horizontal car or the
+  /// column of a vertical car.
+  /// </summary>
+  int getLane(int index) const noexcept;
+
+  /// <summary>
+  /// Get the index of a car in the layout.
+  /// </summary>
+  /// <returns>The car's index, -1 if the car is not in the layout.</returns>
+  int getIndex(int id) const noexcept;
+
+ private:
+  int board_size_{0};
+  int main_id_{0};
+  int main_index_{0};
+  std::vector<int> ids_;
+  std::vector<int> lengths_;
+  std::vector<Car::Direction> directions_;
+  std::vector<int> lanes_;
+  // Cells covered by each car at each position, kMaxBoardSize per car
+  std::vector<std::uint64_t> masks_;
+};
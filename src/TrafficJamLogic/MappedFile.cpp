@@ -0,0 +1,121 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string &path) {
+#ifdef _WIN32
+  this->file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (this->file_ == INVALID_HANDLE_VALUE) {
+    this->file_ = nullptr;
+    throw std::runtime_error("Cannot open " + path);
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(this->file_, &size)) {
+    this->release();
+    throw std::runtime_error("Cannot read the size of " + path);
+  }
+  this->size_ = static_cast<std::size_t>(size.QuadPart);
+
+  if (this->size_ > 0) {
+    this->mapping_ = CreateFileMappingA(this->file_, nullptr, PAGE_READONLY, 0,
+                                        0, nullptr);
+    if (this->mapping_ == nullptr) {
+      this->release();
+      throw std::runtime_error("Cannot map " + path);
+    }
+    this->data_ = static_cast<const std::uint8_t *>(
+        MapViewOfFile(this->mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (this->data_ == nullptr) {
+      this->release();
+      throw std::runtime_error("Cannot map " + path);
+    }
+  }
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open " + path);
+  }
+
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw std::runtime_error("Cannot read the size of " + path);
+  }
+  this->size_ = static_cast<std::size_t>(st.st_size);
+
+  if (this->size_ > 0) {
+    void *data = mmap(nullptr, this->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      this->size_ = 0;
+      throw std::runtime_error("Cannot map " + path);
+    }
+    // The whole file is read front to back by our readers
+    madvise(data, this->size_, MADV_WILLNEED);
+    this->data_ = static_cast<const std::uint8_t *>(data);
+  }
+
+  // The mapping stays valid after closing the descriptor
+  close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() { this->release(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept { *this = std::move(other); }
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    this->release();
+    std::swap(this->data_, other.data_);
+    std::swap(this->size_, other.size_);
+#ifdef _WIN32
+    std::swap(this->file_, other.file_);
+    std::swap(this->mapping_, other.mapping_);
+#endif
+  }
+  return *this;
+}
+
+const std::uint8_t *MappedFile::getData() const noexcept { return this->data_; }
+
+std::size_t MappedFile::getSize() const noexcept { return this->size_; }
+
+void MappedFile::release() noexcept {
+#ifdef _WIN32
+  if (this->data_ != nullptr) {
+    UnmapViewOfFile(this->data_);
+  }
+  if (this->mapping_ != nullptr) {
+    CloseHandle(this->mapping_);
+  }
+  if (this->file_ != nullptr) {
+    CloseHandle(this->file_);
+  }
+  this->mapping_ = nullptr;
+  this->file_ = nullptr;
+#else
+  if (this->data_ != nullptr) {
+    munmap(const_cast<std::uint8_t *>(this->data_), this->size_);
+  }
+#endif
+  this->data_ = nullptr;
+  this->size_ = 0;
+}
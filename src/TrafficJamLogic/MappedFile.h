@@ -0,0 +1,61 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// A read-only memory mapping of a whole file.
+/// The mapping is released when the object is destroyed.
+/// </summary>
+class MappedFile {
+ public:
+  /// <summary>
+  /// A constructor for mapping a file into memory.
+  /// Throws std::runtime_error if the file cannot be opened or mapped.
+  /// </summary>
+  /// <param name="path">The path of the file to map.</param>
+  explicit MappedFile(const std::string &path);
+
+  /// <summary>
+  /// Default constructor. The object does not map any file.
+  /// </summary>
+  MappedFile() = default;
+
+  /// <summary>
+  /// Destructor unmapping the file.
+  /// </summary>
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  /// <summary>
+  /// Default getter for the mapped bytes.
+  /// </summary>
+  /// <returns>A pointer to the first byte of the file, nullptr if the file is
+  /// empty.</returns>
+  const std::uint8_t *getData() const noexcept;
+
+  /// <summary>
+  /// Default getter for the mapped size.
+  /// </summary>
+  /// <returns>The number of bytes in the file.</returns>
+  std::size_t getSize() const noexcept;
+
+ private:
+  void release() noexcept;
+
+  const std::uint8_t *data_{nullptr};
+  std::size_t size_{0};
+#ifdef _WIN32
+  void *file_{nullptr};
+  void *mapping_{nullptr};
+#endif
+};
@@ -0,0 +1,42 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include <iostream>
+#include <tuple>
+
+struct Move {
+  /// <summary>
+  /// A constructor for creating a Move object.
+  /// </summary>
+  /// <param name="car_id">The ID of the car being moved.</param>
+  /// <param name="delta">The number of cells the car is moved by. Positive
+  /// values move the car right (horizontal) or down (vertical).</param>
+  Move(int car_id, int delta) : car_id{car_id}, delta{delta} {};
+
+  /// <summary>
+  /// Default constructor. A default Move does not move any car.
+  /// </summary>
+  Move() = default;
+
+  /// <summary>
+  /// Overloaded << operator to print out the move's properties.
+  /// </summary>
+  friend std::ostream &operator<<(std::ostream &os, const Move &move) noexcept {
+    os << move.car_id << ' ' << move.delta;
+    return os;
+  }
+
+  friend bool operator==(const Move &lhs, const Move &rhs) noexcept {
+    return std::tie(lhs.car_id, lhs.delta) == std::tie(rhs.car_id, rhs.delta);
+  }
+
+  friend bool operator!=(const Move &lhs, const Move &rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+  int car_id{0};
+  int delta{0};
+};
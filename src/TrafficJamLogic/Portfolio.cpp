@@ -0,0 +1,94 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "Portfolio.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+Portfolio::Engine Portfolio::aStar(std::string name, AStar::Options options) {
+  // Transposition pruning drops successors by the move a kept duplicate was
+  // reached with, no bound on its solutions is known
+  const double bound = options.generation.prune_transpositions
+                           ? std::numeric_limits<double>::infinity()
+                           : std::max(options.weight, 1.0);
+  return Engine{std::move(name),
+                [options](const Board &board,
+                          const AStar::CancellationToken &cancellation) {
+                  AStar::Options engine_options = options;
+                  engine_options.cancellation = cancellation;
+                  return AStar::search(board, engine_options);
+                },
+                bound};
+}
+
+std::vector<Portfolio::Engine> Portfolio::getDefaultEngines() {
+  AStar::Options greedy{};
+  greedy.weight = 5.0;
+  greedy.generation.prune_transpositions = true;
+
+  return {aStar("greedy", greedy), aStar("astar")};
+}
+
+Portfolio::Result Portfolio::solve(const Board &board,
+                                   const std::vector<Engine> &engines,
+                                   double max_bound) {
+  std::vector<const Engine *> running{};
+  for (const auto &engine : engines) {
+    if (engine.bound <= max_bound) {
+      running.emplace_back(&engine);
+    }
+  }
+  if (running.empty()) {
+    throw std::invalid_argument("No engine meets the requested bound");
+  }
+
+  AStar::CancellationToken cancellation{};
+  std::promise<Result> winner{};
+  auto result = winner.get_future();
+  // Set once, by the first engine to finish or the last one to fail
+  std::atomic<bool> decided{false};
+  std::atomic<std::size_t> remaining{running.size()};
+  std::exception_ptr error{};
+  std::mutex error_mutex{};
+
+  std::vector<std::thread> threads{};
+  for (const Engine *engine : running) {
+    threads.emplace_back([&, engine] {
+      try {
+        auto path = engine->solve(board, cancellation);
+        if (!decided.exchange(true)) {
+          winner.set_value(
+              Result{std::move(path), engine->name, engine->bound});
+        }
+      } catch (const AStar::SearchCancelled &) {
+      } catch (...) {
+        std::lock_guard<std::mutex> lock{error_mutex};
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+
+      if (--remaining == 0 && !decided.exchange(true)) {
+        winner.set_exception(error);
+      }
+    });
+  }
+
+  // Cancel the losers and wait for them before returning
+  result.wait();
+  cancellation.cancel();
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  return result.get();
+}
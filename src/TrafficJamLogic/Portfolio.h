@@ -0,0 +1,64 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "AStar.h"
+#include "Board.h"
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Portfolio {
+/// <summary>
+/// A configured search engine. solve must return the solution of a board,
+/// empty if the board cannot be solved, and should stop by throwing
+/// AStar::SearchCancelled once the token is cancelled.
+/// </summary>
+struct Engine {
+  std::string name{};
+  std::function<std::vector<std::shared_ptr<Board>>(
+      const Board &board, const AStar::CancellationToken &cancellation)>
+      solve{};
+  /// <summary>
+  /// The cost of the engine's solutions is at most bound times the optimal
+  /// cost, 1 for an optimal engine.
+  /// </summary>
+  double bound{1.0};
+};
+
+struct Result {
+  std::vector<std::shared_ptr<Board>> path{};
+  /// <summary>
+  /// The name of the engine that found the solution.
+  /// </summary>
+  std::string engine{};
+  double bound{1.0};
+};
+
+/// <summary>
+/// An engine running AStar::search, its bound is the weight of the options.
+/// Engines pruning transpositions have no bound.
+/// </summary>
+Engine aStar(std::string name, AStar::Options options = {});
+
+/// <summary>
+/// The default portfolio: a greedy weighted A* pruning transpositions that
+/// is fast on easy boards, and an optimal A* without pruning.
+/// </summary>
+std::vector<Engine> getDefaultEngines();
+
+/// <summary>
+/// Race engines on a board, each on a thread of its own. The first engine to
+/// finish wins and the others are cancelled. Engines whose bound exceeds
+/// max_bound are not run.
+/// Throws std::invalid_argument if no engine meets max_bound, and rethrows
+/// the error of an engine if every engine failed.
+/// </summary>
+Result solve(const Board &board, const std::vector<Engine> &engines,
+             double max_bound = std::numeric_limits<double>::infinity());
+}  // namespace Portfolio
@@ -0,0 +1,250 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "PuzzleCorpus.h"
+
+#include "CorpusReader.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+constexpr char kMagic[4] = {'T', 'J', 'P', 'C'};
+constexpr std::uint8_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 8;
+constexpr int kMaxId = 63;
+constexpr std::size_t kBufferBytes = std::size_t{1} << 20;
+
+/// <summary>
+/// Map a grid cell to the cell letters of CompactBoard::parse.
+/// </summary>
+char toLetter(char c) noexcept {
+  if (c == '0') {
+    return 'o';
+  }
+  if (c >= '1' && c <= '9') {
+    return static_cast<char>('A' + (c - '1'));
+  }
+  return c;
+}
+}  // namespace
+
+CompactBoard::Car PuzzleCorpus::Record::getCar(int index) const noexcept {
+  const auto *bytes = this->data_ + 1 + 2 * index;
+  const int packed = bytes[0] | bytes[1] << 8;
+
+  const int cell = packed & 0x3f;
+  const int direction = packed >> 6 & 1;
+  const int row = cell / this->board_size_;
+  const int col = cell % this->board_size_;
+  const bool horizontal = direction == Car::Horizontal;
+  return CompactBoard::Car{static_cast<std::uint8_t>(packed >> 10),
+                           static_cast<std::uint8_t>((packed >> 7 & 7) + 1),
+                           static_cast<std::uint8_t>(direction),
+                           static_cast<std::uint8_t>(horizontal ? row : col),
+                           static_cast<std::uint8_t>(horizontal ? col : row)};
+}
+
+CompactBoard PuzzleCorpus::Record::toCompactBoard() const {
+  const int count = this->getCarCount();
+  if (count > Layout::kMaxCars) {
+    throw std::invalid_argument("Board is too large for a packed layout");
+  }
+  CompactBoard::Car cars[Layout::kMaxCars];
+  for (auto i = 0; i < count; ++i) {
+    cars[i] = this->getCar(i);
+  }
+  return CompactBoard{this->board_size_, this->main_id_, cars, count};
+}
+
+PuzzleCorpus::PuzzleCorpus(const std::string &path) : file_{path} {
+  if (!isCorpus(this->file_)) {
+    throw std::runtime_error(path + " is not a puzzle corpus");
+  }
+  const std::uint8_t *data = this->file_.getData();
+  this->board_size_ = data[5];
+  this->main_id_ = data[6];
+  if (this->board_size_ == 0 || this->board_size_ > Layout::kMaxBoardSize) {
+    throw std::runtime_error(path + " has an invalid board size");
+  }
+
+  // Check the records once, so iterating never reads past the mapping and
+  // every record decodes to a valid board
+  const std::size_t size = this->file_.getSize();
+  for (std::size_t offset = kHeaderSize; offset < size; ++this->size_) {
+    const Record record{data + offset, this->board_size_, this->main_id_};
+    offset += record.getSize();
+    if (offset > size) {
+      throw std::runtime_error(path + " has a truncated record");
+    }
+    try {
+      record.toCompactBoard();
+    } catch (const std::invalid_argument &e) {
+      throw std::runtime_error(path + ": record " +
+                               std::to_string(this->size_) + ": " + e.what());
+    }
+  }
+}
+
+bool PuzzleCorpus::isCorpus(const MappedFile &file) noexcept {
+  return file.getSize() >= kHeaderSize &&
+         std::string_view(reinterpret_cast<const char *>(file.getData()),
+                          sizeof(kMagic)) ==
+             std::string_view(kMagic, sizeof(kMagic)) &&
+         file.getData()[sizeof(kMagic)] == kVersion;
+}
+
+PuzzleCorpus::Iterator PuzzleCorpus::begin() const noexcept {
+  return Iterator{Record{this->file_.getData() + kHeaderSize,
+                         this->board_size_, this->main_id_}};
+}
+
+PuzzleCorpus::Iterator PuzzleCorpus::end() const noexcept {
+  return Iterator{Record{this->file_.getData() + this->file_.getSize(),
+                         this->board_size_, this->main_id_}};
+}
+
+std::size_t PuzzleCorpus::convertLines(const std::string &text_path,
+                                       const std::string &corpus_path) {
+  const auto boards = CorpusReader::read(text_path);
+  PuzzleCorpusWriter writer{corpus_path,
+                            boards.empty() ? 6 : boards[0].getBoardSize()};
+  for (const auto &board : boards) {
+    writer.write(board);
+  }
+  writer.close();
+  return boards.size();
+}
+
+std::size_t PuzzleCorpus::convertGrids(const std::string &text_path,
+                                       const std::string &corpus_path) {
+  std::ifstream text{text_path};
+  if (!text) {
+    throw std::runtime_error("Cannot open " + text_path);
+  }
+
+  std::vector<CompactBoard> boards{};
+  std::string cells{};
+  std::string line{};
+  std::size_t line_number = 0;
+  std::size_t first_line = 0;
+  auto parse = [&]() {
+    if (cells.empty()) {
+      return;
+    }
+    try {
+      boards.emplace_back(CompactBoard::parse(cells.data(), cells.size()));
+    } catch (const std::invalid_argument &e) {
+      throw std::invalid_argument(text_path + ":" +
+                                  std::to_string(first_line) + ": " +
+                                  e.what());
+    }
+    cells.clear();
+  };
+
+  while (std::getline(text, line)) {
+    ++line_number;
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty()) {
+      parse();
+      continue;
+    }
+    if (cells.empty()) {
+      first_line = line_number;
+    }
+    std::transform(line.begin(), line.end(), std::back_inserter(cells),
+                   toLetter);
+  }
+  parse();
+
+  PuzzleCorpusWriter writer{corpus_path,
+                            boards.empty() ? 6 : boards[0].getBoardSize()};
+  for (const auto &board : boards) {
+    writer.write(board);
+  }
+  writer.close();
+  return boards.size();
+}
+
+PuzzleCorpusWriter::PuzzleCorpusWriter(const std::string &path,
+                                       int board_size, int main_id)
+    : file_{nullptr}, board_size_{board_size}, main_id_{main_id} {
+  // Check the arguments before the file is created or truncated
+  if (board_size < 1 || board_size > Layout::kMaxBoardSize) {
+    throw std::invalid_argument("Board is too large for a packed layout");
+  }
+  if (main_id < 1 || main_id > kMaxId) {
+    throw std::invalid_argument("Main car ID must be from 1 to 63");
+  }
+  this->file_ = std::fopen(path.c_str(), "wb");
+  if (this->file_ == nullptr) {
+    throw std::runtime_error("Cannot open " + path);
+  }
+
+  this->buffer_.reserve(kBufferBytes + 64);
+  this->buffer_.insert(this->buffer_.end(), kMagic, kMagic + sizeof(kMagic));
+  this->buffer_.insert(this->buffer_.end(),
+                       {kVersion, static_cast<std::uint8_t>(board_size),
+                        static_cast<std::uint8_t>(main_id), 0});
+}
+
+PuzzleCorpusWriter::~PuzzleCorpusWriter() {
+  try {
+    this->close();
+  } catch (const std::exception &) {
+  }
+}
+
+void PuzzleCorpusWriter::write(const CompactBoard &board) {
+  if (board.getBoardSize() != this->board_size_ ||
+      board.getMainId() != this->main_id_) {
+    throw std::invalid_argument("Board does not match the corpus");
+  }
+  for (auto i = 0; i < board.getCarCount(); ++i) {
+    if (board.getCar(i).id > kMaxId) {
+      throw std::invalid_argument("Car IDs must be at most 63");
+    }
+  }
+
+  this->buffer_.push_back(static_cast<std::uint8_t>(board.getCarCount()));
+  for (auto i = 0; i < board.getCarCount(); ++i) {
+    const auto &car = board.getCar(i);
+    const bool horizontal = car.direction == Car::Horizontal;
+    const int row = horizontal ? car.lane : car.position;
+    const int col = horizontal ? car.position : car.lane;
+    const int packed = (row * this->board_size_ + col) | car.direction << 6 |
+                       (car.length - 1) << 7 | car.id << 10;
+    this->buffer_.push_back(static_cast<std::uint8_t>(packed & 0xff));
+    this->buffer_.push_back(static_cast<std::uint8_t>(packed >> 8));
+  }
+
+  if (this->buffer_.size() >= kBufferBytes) {
+    const auto written = std::fwrite(this->buffer_.data(), 1,
+                                     this->buffer_.size(), this->file_);
+    const bool complete = written == this->buffer_.size();
+    this->buffer_.clear();
+    if (!complete) {
+      throw std::runtime_error("Cannot write puzzle corpus");
+    }
+  }
+}
+
+void PuzzleCorpusWriter::close() {
+  if (this->file_ == nullptr) {
+    return;
+  }
+  const auto written =
+      std::fwrite(this->buffer_.data(), 1, this->buffer_.size(), this->file_);
+  const bool complete = written == this->buffer_.size();
+  this->buffer_.clear();
+  const bool closed = std::fclose(this->file_) == 0;
+  this->file_ = nullptr;
+  if (!complete || !closed) {
+    throw std::runtime_error("Cannot write puzzle corpus");
+  }
+}
@@ -0,0 +1,213 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "Board.h"
+#include "CompactBoard.h"
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// A packed binary corpus of puzzles sharing a board size and main car ID.
+/// The file starts with an 8-byte header: "TJPC", a version byte, the board
+/// size, the main car's ID and a reserved byte. Each puzzle is a record of a
+/// car count byte followed by 2 little-endian bytes per car: the top-left
+/// cell (row * size + col) in bits 0-5, the direction in bit 6, the length
+/// minus one in bits 7-9 and the car's ID in bits 10-15.
+/// A 6x6 puzzle of 12 cars takes 25 bytes instead of a 36-character line.
+/// The file is memory mapped and records are decoded straight from the
+/// mapping.
+/// </summary>
+class PuzzleCorpus {
+ public:
+  class Iterator;
+
+  /// <summary>
+  /// A non-owning view of a record inside the corpus.
+  /// </summary>
+  class Record {
+   public:
+    Record(const std::uint8_t *data, int board_size, int main_id) noexcept
+        : data_{data}, board_size_{board_size}, main_id_{main_id} {}
+
+    /// <summary>
+    /// Default getter for the number of cars.
+    /// </summary>
+    int getCarCount() const noexcept { return this->data_[0]; }
+
+    /// <summary>
+    /// Decode a car of the record.
+    /// </summary>
+    CompactBoard::Car getCar(int index) const noexcept;
+
+    /// <summary>
+    /// Decode the record into a compact board. Throws std::invalid_argument
+    /// if the record is not a valid board.
+    /// </summary>
+    CompactBoard toCompactBoard() const;
+
+    /// <summary>
+    /// Decode the record into a Board object.
+    /// </summary>
+    Board toBoard() const { return this->toCompactBoard().toBoard(); }
+
+    /// <summary>
+    /// Default getter for the size of the record in bytes.
+    /// </summary>
+    std::size_t getSize() const noexcept { return 1 + 2 * this->data_[0]; }
+
+   private:
+    friend class Iterator;
+
+    const std::uint8_t *data_;
+    int board_size_;
+    int main_id_;
+  };
+
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Record;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Record *;
+    using reference = Record;
+
+    explicit Iterator(const Record &record) noexcept : record_{record} {}
+
+    Record operator*() const noexcept { return this->record_; }
+
+    const Record *operator->() const noexcept { return &this->record_; }
+
+    Iterator &operator++() noexcept {
+      this->record_.data_ += this->record_.getSize();
+      return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+      Iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const Iterator &other) const noexcept {
+      return this->record_.data_ == other.record_.data_;
+    }
+
+    bool operator!=(const Iterator &other) const noexcept {
+      return !(*this == other);
+    }
+
+   private:
+    Record record_;
+  };
+
+  /// <summary>
+  /// A constructor for opening a corpus file. Throws std::runtime_error if
+  /// the file is not a corpus, or a record is truncated or is not a valid
+  /// board, naming the record counted from 0.
+  /// </summary>
+  explicit PuzzleCorpus(const std::string &path);
+
+  /// <summary>
+  /// Check if a file starts with the corpus header.
+  /// </summary>
+  static bool isCorpus(const MappedFile &file) noexcept;
+
+  Iterator begin() const noexcept;
+
+  Iterator end() const noexcept;
+
+  /// <summary>
+  /// Default getter for the number of puzzles.
+  /// </summary>
+  std::size_t size() const noexcept { return this->size_; }
+
+  /// <summary>
+  /// Default getter for board size.
+  /// </summary>
+  int getBoardSize() const noexcept { return this->board_size_; }
+
+  /// <summary>
+  /// Default getter for main car's ID.
+  /// </summary>
+  int getMainId() const noexcept { return this->main_id_; }
+
+  /// <summary>
+  /// Convert a text corpus of one puzzle per line, as read by CorpusReader,
+  /// into a packed corpus.
+  /// </summary>
+  /// <returns>The number of puzzles converted.</returns>
+  static std::size_t convertLines(const std::string &text_path,
+                                  const std::string &corpus_path);
+
+  /// <summary>
+  /// Convert boards written as grids, one row per line and boards separated
+  /// by blank lines, into a packed corpus. Cells are digits as printed by
+  /// Board (0 for an empty cell), or letters as in CompactBoard::parse.
+  /// Throws std::invalid_argument naming the line of a board that cannot be
+  /// parsed.
+  /// </summary>
+  /// <returns>The number of puzzles converted.</returns>
+  static std::size_t convertGrids(const std::string &text_path,
+                                  const std::string &corpus_path);
+
+ private:
+  MappedFile file_;
+  int board_size_{0};
+  int main_id_{0};
+  std::size_t size_{0};
+};
+
+/// <summary>
+/// A writer of packed corpus files. Records are gathered in a buffer and
+/// written with one fwrite per megabyte.
+/// </summary>
+class PuzzleCorpusWriter {
+ public:
+  /// <summary>
+  /// A constructor for creating a corpus file. Throws std::invalid_argument
+  /// if the board size or main car's ID cannot be stored, before the file is
+  /// touched, and std::runtime_error if the file cannot be created.
+  /// </summary>
+  PuzzleCorpusWriter(const std::string &path, int board_size, int main_id = 1);
+
+  /// <summary>
+  /// Closes the writer, ignoring errors. Call close() to see them.
+  /// </summary>
+  ~PuzzleCorpusWriter();
+
+  PuzzleCorpusWriter(const PuzzleCorpusWriter &) = delete;
+  PuzzleCorpusWriter &operator=(const PuzzleCorpusWriter &) = delete;
+
+  /// <summary>
+  /// Append a puzzle. Throws std::invalid_argument if its board size or main
+  /// car's ID differ from the corpus, or a car ID is above 63.
+  /// </summary>
+  void write(const CompactBoard &board);
+
+  /// <summary>
+  /// Append a puzzle. Throws std::invalid_argument if the board does not fit
+  /// the corpus.
+  /// </summary>
+  void write(const Board &board) { this->write(CompactBoard{board}); }
+
+  /// <summary>
+  /// Write the buffered records and close the file. Throws
+  /// std::runtime_error if the write fails.
+  /// </summary>
+  void close();
+
+ private:
+  std::FILE *file_;
+  int board_size_;
+  int main_id_;
+  std::vector<std::uint8_t> buffer_;
+};
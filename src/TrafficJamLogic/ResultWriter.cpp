@@ -0,0 +1,223 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "ResultWriter.h"
+
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+constexpr char kMagic[4] = {'T', 'J', 'R', 'B'};
+constexpr char kVersion = 1;
+// ID followed by the move count
+constexpr std::size_t kRecordHeaderSize = 6;
+constexpr std::uint16_t kUnsolvable = 0xffff;
+
+void putU16(std::string &out, std::uint32_t value) {
+  out.push_back(static_cast<char>(value & 0xff));
+  out.push_back(static_cast<char>(value >> 8 & 0xff));
+}
+
+bool endsWith(const std::string &s, const std::string &suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+}  // namespace
+
+ResultWriter::ResultWriter(const std::string &path, Format format,
+                           std::size_t buffer_bytes)
+    : ResultWriter{std::fopen(path.c_str(), "wb"), format, buffer_bytes} {
+  if (this->file_ == nullptr) {
+    throw std::runtime_error("Cannot open " + path);
+  }
+  this->owns_file_ = true;
+}
+
+ResultWriter::ResultWriter(std::FILE *file, Format format,
+                           std::size_t buffer_bytes)
+    : file_{file},
+      owns_file_{false},
+      format_{format},
+      buffer_bytes_{buffer_bytes} {
+  // Room for a full buffer and the record that overflows it
+  this->buffer_.reserve(buffer_bytes + 4096);
+
+  if (format == Format::Binary) {
+    this->buffer_.append(kMagic, sizeof(kMagic));
+    this->buffer_.push_back(kVersion);
+  } else if (format == Format::Json) {
+    this->buffer_.push_back('[');
+  }
+}
+
+ResultWriter::~ResultWriter() {
+  try {
+    this->close();
+  } catch (const std::exception &) {
+  }
+}
+
+void ResultWriter::write(std::uint32_t id, const std::vector<Move> &moves) {
+  this->beginRecord(id, true);
+  for (const auto &move : moves) {
+    this->putMove(move);
+  }
+  this->endRecord(true);
+}
+
+void ResultWriter::write(std::uint32_t id,
+                         const std::vector<std::shared_ptr<Board>> &path) {
+  this->beginRecord(id, !path.empty());
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    this->putMove(path[i - 1]->getMoveTo(*path[i]));
+  }
+  this->endRecord(!path.empty());
+}
+
+void ResultWriter::write(std::uint32_t id,
+                         const AStar::SolutionRange &solution) {
+  this->beginRecord(id, !solution.empty());
+  // Every board after the start records the move that produced it
+  for (auto it = solution.begin(); it != solution.end(); ++it) {
+    if (it != solution.begin()) {
+      this->putMove(it->getLastMove());
+    }
+  }
+  this->endRecord(!solution.empty());
+}
+
+void ResultWriter::flush() {
+  if (this->file_ == nullptr || this->buffer_.empty()) {
+    return;
+  }
+  const auto written =
+      std::fwrite(this->buffer_.data(), 1, this->buffer_.size(), this->file_);
+  const bool complete = written == this->buffer_.size();
+  this->buffer_.clear();
+  if (!complete || std::fflush(this->file_) != 0) {
+    throw std::runtime_error("Cannot write results");
+  }
+}
+
+void ResultWriter::close() {
+  if (this->file_ == nullptr) {
+    return;
+  }
+  if (this->format_ == Format::Json) {
+    this->buffer_.append("]\n");
+  }
+
+  // The file is released even if the last write fails
+  auto file = this->file_;
+  try {
+    this->flush();
+  } catch (const std::runtime_error &) {
+    if (this->owns_file_) {
+      std::fclose(file);
+    }
+    this->file_ = nullptr;
+    throw;
+  }
+  this->file_ = nullptr;
+  if (this->owns_file_ && std::fclose(file) != 0) {
+    throw std::runtime_error("Cannot write results");
+  }
+}
+
+ResultWriter::Format ResultWriter::getFormat(const std::string &path) {
+  if (endsWith(path, ".bin")) {
+    return Format::Binary;
+  }
+  if (endsWith(path, ".json")) {
+    return Format::Json;
+  }
+  return Format::Text;
+}
+
+void ResultWriter::beginRecord(std::uint32_t id, bool solved) {
+  this->record_start_ = this->buffer_.size();
+  this->record_moves_ = 0;
+
+  switch (this->format_) {
+    case Format::Text:
+      this->putNumber(id);
+      this->buffer_.append(solved ? ":" : ": unsolvable");
+      break;
+    case Format::Binary:
+      putU16(this->buffer_, id & 0xffff);
+      putU16(this->buffer_, id >> 16);
+      putU16(this->buffer_, solved ? 0 : kUnsolvable);
+      break;
+    case Format::Json:
+      this->buffer_.append(this->records_ == 0 ? "\n{\"id\":" : ",\n{\"id\":");
+      this->putNumber(id);
+      this->buffer_.append(solved ? ",\"moves\":[" : ",\"moves\":null");
+      break;
+  }
+}
+
+void ResultWriter::putMove(const Move &move) {
+  switch (this->format_) {
+    case Format::Text:
+      this->buffer_.push_back(' ');
+      this->putNumber(move.car_id);
+      if (move.delta > 0) {
+        this->buffer_.push_back('+');
+      }
+      this->putNumber(move.delta);
+      break;
+    case Format::Binary:
+      if (move.car_id < 1 || move.car_id > 15 || move.delta < -8 ||
+          move.delta > 7) {
+        // Drop the partial record so the output stays readable
+        this->buffer_.resize(this->record_start_);
+        throw std::invalid_argument("Move does not fit in a byte");
+      }
+      this->buffer_.push_back(
+          static_cast<char>(move.car_id << 4 | (move.delta & 0xf)));
+      break;
+    case Format::Json:
+      this->buffer_.append(this->record_moves_ == 0 ? "[" : ",[");
+      this->putNumber(move.car_id);
+      this->buffer_.push_back(',');
+      this->putNumber(move.delta);
+      this->buffer_.push_back(']');
+      break;
+  }
+  ++this->record_moves_;
+}
+
+void ResultWriter::endRecord(bool solved) {
+  switch (this->format_) {
+    case Format::Text:
+      this->buffer_.push_back('\n');
+      break;
+    case Format::Binary:
+      if (solved) {
+        if (this->record_moves_ >= kUnsolvable) {
+          this->buffer_.resize(this->record_start_);
+          throw std::invalid_argument("Too many moves for a record");
+        }
+        // The move count is known once the moves are written
+        const auto count = this->record_start_ + kRecordHeaderSize - 2;
+        this->buffer_[count] = static_cast<char>(this->record_moves_ & 0xff);
+        this->buffer_[count + 1] = static_cast<char>(this->record_moves_ >> 8);
+      }
+      break;
+    case Format::Json:
+      this->buffer_.append(solved ? "]}" : "}");
+      break;
+  }
+  ++this->records_;
+
+  if (this->buffer_.size() >= this->buffer_bytes_) {
+    this->flush();
+  }
+}
+
+void ResultWriter::putNumber(std::int64_t value) {
+  char digits[16];
+  const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  this->buffer_.append(digits, result.ptr);
+}
@@ -0,0 +1,115 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "AStar.h"
+#include "Board.h"
+#include "Move.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// A writer of solutions to a file, one record per solved board.
+/// Records are formatted into a buffer that is reused between records and
+/// written with a single fwrite once it fills up, instead of streaming every
+/// number through iostream.
+/// Formats:
+/// - Text: one line per board, the ID followed by the moves, each written as
+///   the car's ID and the signed delta ("3: 4+1 7-2 1+4"). An unsolvable
+///   board is written as "3: unsolvable".
+/// - Binary: the header "TJRB" and a version byte, then per board a 32-bit
+///   little-endian ID, a 16-bit little-endian move count (0xffff for an
+///   unsolvable board) and one byte per move, the car's ID in the high 4 bits
+///   and the delta in the low 4 bits as a signed number.
+/// - Json: an array of objects {"id":3,"moves":[[4,1],[7,-2]]}, with null
+///   moves for an unsolvable board.
+/// </summary>
+class ResultWriter {
+ public:
+  enum class Format { Text, Binary, Json };
+
+  /// <summary>
+  /// A constructor for creating a writer to a new file. Throws
+  /// std::runtime_error if the file cannot be created.
+  /// </summary>
+  /// <param name="buffer_bytes">The number of bytes gathered before they are
+  /// written.</param>
+  ResultWriter(const std::string &path, Format format,
+               std::size_t buffer_bytes = std::size_t{1} << 20);
+
+  /// <summary>
+  /// A constructor for creating a writer to an open file such as stdout. The
+  /// file is flushed but not closed by the writer.
+  /// </summary>
+  ResultWriter(std::FILE *file, Format format,
+               std::size_t buffer_bytes = std::size_t{1} << 20);
+
+  /// <summary>
+  /// Closes the writer, ignoring errors. Call close() to see them.
+  /// </summary>
+  ~ResultWriter();
+
+  ResultWriter(const ResultWriter &) = delete;
+  ResultWriter &operator=(const ResultWriter &) = delete;
+
+  /// <summary>
+  /// Write the moves of a solution. Throws std::invalid_argument if a move
+  /// does not fit the binary format.
+  /// </summary>
+  void write(std::uint32_t id, const std::vector<Move> &moves);
+
+  /// <summary>
+  /// Write the moves between the boards of a solution path, an empty path is
+  /// written as an unsolvable board.
+  /// </summary>
+  void write(std::uint32_t id, const std::vector<std::shared_ptr<Board>> &path);
+
+  /// <summary>
+  /// Write the moves of a solution range, an empty range is written as an
+  /// unsolvable board.
+  /// </summary>
+  void write(std::uint32_t id, const AStar::SolutionRange &solution);
+
+  /// <summary>
+  /// Write every buffered record to the file. Throws std::runtime_error if
+  /// the write fails.
+  /// </summary>
+  void flush();
+
+  /// <summary>
+  /// Finish the output and flush it, closing a file opened by the writer.
+  /// Throws std::runtime_error if the write fails.
+  /// </summary>
+  void close();
+
+  /// <summary>
+  /// Choose a format from the extension of a path: ".bin" is Binary,
+  /// ".json" is Json and anything else is Text.
+  /// </summary>
+  static Format getFormat(const std::string &path);
+
+ private:
+  void beginRecord(std::uint32_t id, bool solved);
+
+  void putMove(const Move &move);
+
+  void endRecord(bool solved);
+
+  void putNumber(std::int64_t value);
+
+  std::FILE *file_;
+  bool owns_file_;
+  Format format_;
+  std::size_t buffer_bytes_;
+  std::string buffer_;
+  std::size_t records_{0};
+  // Start and move count of the record being written
+  std::size_t record_start_{0};
+  std::size_t record_moves_{0};
+};
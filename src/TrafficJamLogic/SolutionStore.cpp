@@ -0,0 +1,379 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "SolutionStore.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr char kMagic[4] = {'T', 'J', 'S', 'S'};
+// Version 1 stores are a log only, version 2 stores start with sorted records
+constexpr std::uint8_t kLogVersion = 1;
+constexpr std::uint8_t kVersion = 2;
+constexpr std::size_t kLogHeaderSize = sizeof(kMagic) + 1;
+// Magic, version, 3 reserved bytes and a 64-bit number of sorted records
+constexpr std::size_t kHeaderSize = 16;
+// Key size byte followed by a 16-bit little endian move count
+constexpr std::size_t kRecordHeaderSize = 3;
+
+std::uint64_t readU64(const std::uint8_t *data) noexcept {
+  std::uint64_t value = 0;
+  for (auto i = 7; i >= 0; --i) {
+    value = value << 8 | data[i];
+  }
+  return value;
+}
+
+void appendU64(std::vector<std::uint8_t> &bytes, std::uint64_t value) {
+  for (auto i = 0; i < 8; ++i) {
+    bytes.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+  }
+}
+
+/// <summary>
+/// Get the size of the record at an offset, 0 if the record runs past end.
+/// </summary>
+std::size_t getRecordSize(const std::uint8_t *data, std::size_t offset,
+                          std::size_t end) noexcept {
+  if (offset > end || end - offset < kRecordHeaderSize) {
+    return 0;
+  }
+  const std::size_t key_size = data[offset];
+  const std::size_t move_count = data[offset + 1] | (data[offset + 2] << 8);
+  const std::size_t record_size =
+      kRecordHeaderSize + key_size + 2 * move_count;
+  return record_size <= end - offset ? record_size : 0;
+}
+
+bool writeAll(std::FILE *file, const std::vector<std::uint8_t> &bytes) {
+  return std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size() &&
+         std::fflush(file) == 0;
+}
+
+bool truncateFile(std::FILE *file, std::size_t size) {
+  if (std::fflush(file) != 0) {
+    return false;
+  }
+#ifdef _WIN32
+  return _chsize_s(_fileno(file), static_cast<__int64>(size)) == 0;
+#else
+  return ftruncate(fileno(file), static_cast<off_t>(size)) == 0;
+#endif
+}
+}  // namespace
+
+std::vector<Move> SolutionStore::Solution::getMoves() const {
+  std::vector<Move> moves{};
+  moves.reserve(this->size_);
+
+  for (std::size_t i = 0; i < this->size_; ++i) {
+    moves.emplace_back((*this)[i]);
+  }
+
+  return moves;
+}
+
+SolutionStore::SolutionStore(const std::string &path) : path_{path} {
+  // Create the file with a header if it is new or empty
+  this->file_ = std::fopen(path.c_str(), "ab");
+  if (this->file_ == nullptr) {
+    throw std::runtime_error("Cannot open " + path);
+  }
+  std::fseek(this->file_, 0, SEEK_END);
+  if (std::ftell(this->file_) == 0) {
+    std::vector<std::uint8_t> header{kMagic, kMagic + sizeof(kMagic)};
+    header.insert(header.end(), {kVersion, 0, 0, 0});
+    appendU64(header, 0);
+    if (!writeAll(this->file_, header)) {
+      std::fclose(this->file_);
+      throw std::runtime_error("Cannot write " + path);
+    }
+  }
+
+  try {
+    // An interrupted append leaves at most one truncated record at the end
+    // of the file. Cut it off, or the next record would be appended after it
+    this->end_ = this->load();
+    if (this->end_ < this->mapped_.getSize()) {
+      this->index_.clear();
+      this->mapped_ = MappedFile{};
+      if (!truncateFile(this->file_, this->end_)) {
+        throw std::runtime_error("Cannot truncate " + path);
+      }
+      this->load();
+    }
+  } catch (const std::runtime_error &) {
+    std::fclose(this->file_);
+    throw;
+  }
+}
+
+SolutionStore::~SolutionStore() {
+  if (this->file_ != nullptr) {
+    std::fclose(this->file_);
+  }
+}
+
+std::size_t SolutionStore::load() {
+  this->mapped_ = MappedFile{this->path_};
+
+  const std::uint8_t *data = this->mapped_.getData();
+  const std::size_t size = this->mapped_.getSize();
+
+  if (size < kLogHeaderSize ||
+      std::string_view(reinterpret_cast<const char *>(data), sizeof(kMagic)) !=
+          std::string_view(kMagic, sizeof(kMagic)) ||
+      (data[sizeof(kMagic)] != kLogVersion &&
+       data[sizeof(kMagic)] != kVersion)) {
+    throw std::runtime_error(this->path_ + " is not a solution store");
+  }
+
+  // The sorted records follow the offset table, the last of them ends where
+  // the log starts
+  this->sorted_ = nullptr;
+  this->sorted_count_ = 0;
+  this->sorted_end_ = kLogHeaderSize;
+  if (data[sizeof(kMagic)] == kVersion) {
+    if (size < kHeaderSize) {
+      throw std::runtime_error(this->path_ + " is not a solution store");
+    }
+    const auto count = readU64(data + sizeof(kMagic) + 4);
+    if (count > (size - kHeaderSize) / 8) {
+      throw std::runtime_error(this->path_ + " has a corrupt offset table");
+    }
+    this->sorted_ = data + kHeaderSize;
+    this->sorted_count_ = static_cast<std::size_t>(count);
+    this->sorted_end_ = kHeaderSize + 8 * this->sorted_count_;
+    if (this->sorted_count_ > 0) {
+      const auto last =
+          readU64(this->sorted_ + 8 * (this->sorted_count_ - 1));
+      const auto last_size = getRecordSize(
+          data, static_cast<std::size_t>(std::min<std::uint64_t>(last, size)),
+          size);
+      if (last < this->sorted_end_ || last_size == 0) {
+        throw std::runtime_error(this->path_ + " has a corrupt offset table");
+      }
+      this->sorted_end_ = static_cast<std::size_t>(last) + last_size;
+    }
+  }
+
+  // Records of the log are only indexed, their bytes stay in the mapping
+  std::size_t offset = this->sorted_end_;
+  for (std::size_t record_size = 0;
+       (record_size = getRecordSize(data, offset, size)) != 0;
+       offset += record_size) {
+    const auto *key = data + offset + kRecordHeaderSize;
+    const std::size_t key_size = data[offset];
+    const std::size_t move_count =
+        (record_size - kRecordHeaderSize - key_size) / 2;
+    this->index_.emplace(
+        std::string_view(reinterpret_cast<const char *>(key), key_size),
+        Solution{key + key_size, move_count});
+  }
+  return offset;
+}
+
+std::string SolutionStore::getKey(const Board &board) {
+  const auto &game_board = board.getGameBoard();
+  std::string key{};
+  key.reserve(game_board.size() + 2);
+
+  key.push_back(static_cast<char>(board.getBoardSize()));
+  key.push_back(static_cast<char>(board.getMainId()));
+  for (const auto &cell : game_board) {
+    if (cell < 0 || cell > UINT8_MAX) {
+      throw std::invalid_argument("Car IDs must fit in a byte");
+    }
+    key.push_back(static_cast<char>(cell));
+  }
+
+  return key;
+}
+
+bool SolutionStore::find(const Board &board, Solution &solution) const {
+  return this->find(getKey(board), solution);
+}
+
+std::string_view SolutionStore::getSortedKey(std::size_t index,
+                                             Solution &solution) const {
+  const std::uint8_t *data = this->mapped_.getData();
+  const auto offset = readU64(this->sorted_ + 8 * index);
+  if (offset < kHeaderSize + 8 * this->sorted_count_ ||
+      offset >= this->sorted_end_ ||
+      getRecordSize(data, static_cast<std::size_t>(offset),
+                    this->sorted_end_) == 0) {
+    throw std::runtime_error(this->path_ + " has a corrupt offset table");
+  }
+
+  const auto *record = data + offset;
+  const std::size_t key_size = record[0];
+  solution = Solution{record + kRecordHeaderSize + key_size,
+                      static_cast<std::size_t>(record[1] | record[2] << 8)};
+  return std::string_view(
+      reinterpret_cast<const char *>(record + kRecordHeaderSize), key_size);
+}
+
+bool SolutionStore::find(std::string_view key, Solution &solution) const {
+  // Binary search the sorted records, then look in the log
+  std::size_t low = 0;
+  std::size_t high = this->sorted_count_;
+  while (low < high) {
+    const std::size_t middle = low + (high - low) / 2;
+    Solution candidate{};
+    const auto candidate_key = this->getSortedKey(middle, candidate);
+    if (candidate_key == key) {
+      solution = candidate;
+      return true;
+    }
+    if (candidate_key < key) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  auto it = this->index_.find(key);
+  if (it != this->index_.end()) {
+    solution = it->second;
+    return true;
+  }
+
+  return false;
+}
+
+bool SolutionStore::append(const Board &board, const std::vector<Move> &moves) {
+  auto key = getKey(board);
+  Solution existing{};
+
+  if (key.size() > UINT8_MAX || moves.size() > UINT16_MAX) {
+    throw std::invalid_argument("Board or solution is too large to store");
+  }
+
+  if (this->find(key, existing)) {
+    return false;
+  }
+  if (this->file_ == nullptr) {
+    throw std::runtime_error("Cannot write " + this->path_);
+  }
+
+  std::vector<std::uint8_t> record{
+      static_cast<std::uint8_t>(key.size()),
+      static_cast<std::uint8_t>(moves.size() & 0xFF),
+      static_cast<std::uint8_t>(moves.size() >> 8)};
+  record.insert(record.end(), key.begin(), key.end());
+  for (const auto &move : moves) {
+    if (move.car_id < 0 || move.car_id > UINT8_MAX ||
+        move.delta < INT8_MIN || move.delta > INT8_MAX) {
+      throw std::invalid_argument("Move does not fit in 2 bytes");
+    }
+    record.push_back(static_cast<std::uint8_t>(move.car_id));
+    record.push_back(static_cast<std::uint8_t>(move.delta));
+  }
+
+  // Write the record in one call. If the write fails, cut off whatever part
+  // of it reached the file so the next append starts at a record boundary
+  if (!writeAll(this->file_, record)) {
+    truncateFile(this->file_, this->end_);
+    throw std::runtime_error("Cannot write " + this->path_);
+  }
+  this->end_ += record.size();
+
+  const auto &stored = this->appended_.emplace_back(std::move(record));
+  const auto *stored_key = stored.data() + kRecordHeaderSize;
+  this->index_.emplace(
+      std::string_view(reinterpret_cast<const char *>(stored_key), key.size()),
+      Solution{stored_key + key.size(), moves.size()});
+  return true;
+}
+
+void SolutionStore::compact() {
+  // Gather every record, the views stay valid until the store is reloaded
+  std::vector<std::pair<std::string_view, Solution>> records{};
+  records.reserve(this->size());
+  for (std::size_t i = 0; i < this->sorted_count_; ++i) {
+    Solution solution{};
+    const auto key = this->getSortedKey(i, solution);
+    records.emplace_back(key, solution);
+  }
+  records.insert(records.end(), this->index_.begin(), this->index_.end());
+  std::sort(records.begin(), records.end(),
+            [](const std::pair<std::string_view, Solution> &lhs,
+               const std::pair<std::string_view, Solution> &rhs) {
+              return lhs.first < rhs.first;
+            });
+
+  std::vector<std::uint8_t> bytes{kMagic, kMagic + sizeof(kMagic)};
+  bytes.insert(bytes.end(), {kVersion, 0, 0, 0});
+  appendU64(bytes, records.size());
+  std::uint64_t offset = kHeaderSize + 8 * records.size();
+  for (const auto &record : records) {
+    appendU64(bytes, offset);
+    offset +=
+        kRecordHeaderSize + record.first.size() + 2 * record.second.size();
+  }
+  for (const auto &record : records) {
+    const auto &solution = record.second;
+    bytes.insert(bytes.end(),
+                 {static_cast<std::uint8_t>(record.first.size()),
+                  static_cast<std::uint8_t>(solution.size() & 0xFF),
+                  static_cast<std::uint8_t>(solution.size() >> 8)});
+    bytes.insert(bytes.end(), record.first.begin(), record.first.end());
+    for (std::size_t i = 0; i < solution.size(); ++i) {
+      bytes.push_back(static_cast<std::uint8_t>(solution[i].car_id));
+      bytes.push_back(static_cast<std::uint8_t>(solution[i].delta));
+    }
+  }
+
+  // Write a new file next to the store and replace the store with it
+  const std::string temp_path = this->path_ + ".tmp";
+  std::FILE *temp = std::fopen(temp_path.c_str(), "wb");
+  if (temp == nullptr) {
+    throw std::runtime_error("Cannot open " + temp_path);
+  }
+  const bool written = writeAll(temp, bytes);
+  if (std::fclose(temp) != 0 || !written) {
+    std::remove(temp_path.c_str());
+    throw std::runtime_error("Cannot write " + temp_path);
+  }
+
+  std::fclose(this->file_);
+  this->file_ = nullptr;
+  this->index_.clear();
+  this->appended_.clear();
+  this->mapped_ = MappedFile{};
+#ifdef _WIN32
+  const bool replaced =
+      MoveFileExA(temp_path.c_str(), this->path_.c_str(),
+                  MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+  const bool replaced =
+      std::rename(temp_path.c_str(), this->path_.c_str()) == 0;
+#endif
+  if (!replaced) {
+    std::remove(temp_path.c_str());
+  }
+
+  this->file_ = std::fopen(this->path_.c_str(), "ab");
+  if (this->file_ == nullptr) {
+    throw std::runtime_error("Cannot open " + this->path_);
+  }
+  this->end_ = this->load();
+  if (!replaced) {
+    throw std::runtime_error("Cannot replace " + this->path_);
+  }
+}
+
+std::size_t SolutionStore::size() const noexcept {
+  return this->sorted_count_ + this->index_.size();
+}
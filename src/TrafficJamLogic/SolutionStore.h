@@ -0,0 +1,157 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "Board.h"
+#include "MappedFile.h"
+#include "Move.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// A persistent store of solved boards.
+/// A record holds a board key and its encoded move list. The store file
+/// starts with records sorted by key, after a table of their offsets, and
+/// ends with a log of records appended since the store was last compacted.
+/// The file is memory mapped: sorted records are binary searched in the
+/// mapping and only the log is indexed when the store is opened, so
+/// opening a compacted store does not read any record.
+/// </summary>
+class SolutionStore {
+ public:
+  /// <summary>
+  /// A non-owning view of an encoded move list inside the store.
+  /// Each move is stored in 2 bytes: the car's ID and the signed delta.
+  /// </summary>
+  class Solution {
+   public:
+    /// <summary>
+    /// A constructor for creating a Solution view.
+    /// </summary>
+    /// <param name="data">A pointer to the encoded moves.</param>
+    /// <param name="size">The number of moves.</param>
+    Solution(const std::uint8_t *data, std::size_t size)
+        : data_{data}, size_{size} {};
+
+    /// <summary>
+    /// Default constructor. The view holds no moves.
+    /// </summary>
+    Solution() = default;
+
+    /// <summary>
+    /// Decode the move at the given index.
+    /// </summary>
+    Move operator[](std::size_t i) const noexcept {
+      return Move{this->data_[2 * i],
+                  static_cast<std::int8_t>(this->data_[2 * i + 1])};
+    }
+
+    /// <summary>
+    /// Decode all moves of the solution.
+    /// </summary>
+    /// <returns>An array/vector of Move objects.</returns>
+    std::vector<Move> getMoves() const;
+
+    /// <summary>
+    /// Default getter for the number of moves.
+    /// </summary>
+    std::size_t size() const noexcept { return this->size_; }
+
+   private:
+    const std::uint8_t *data_{nullptr};
+    std::size_t size_{0};
+  };
+
+  /// <summary>
+  /// A constructor for opening a store. The file is created if it does not
+  /// exist, and a record truncated by an interrupted append is cut off.
+  /// Throws std::runtime_error if the file is not a solution store.
+  /// </summary>
+  /// <param name="path">The path of the store file.</param>
+  explicit SolutionStore(const std::string &path);
+
+  /// <summary>
+  /// Destructor closing the store file.
+  /// </summary>
+  ~SolutionStore();
+
+  SolutionStore(const SolutionStore &) = delete;
+  SolutionStore &operator=(const SolutionStore &) = delete;
+
+  /// <summary>
+  /// Create the lookup key of a board. The key holds the board size, the
+  /// main car's ID and one byte per cell.
+  /// </summary>
+  static std::string getKey(const Board &board);
+
+  /// <summary>
+  /// Look up the solution of a board.
+  /// </summary>
+  /// <param name="board">The board to look up.</param>
+  /// <param name="solution">A Solution view set to the stored moves if the
+  /// board is found. The view stays valid until the store is compacted or
+  /// destroyed.</param>
+  /// <returns>True if the board has a stored solution, False if
+  /// otherwise.</returns>
+  bool find(const Board &board, Solution &solution) const;
+
+  /// <summary>
+  /// Append the solution of a board to the store.
+  /// Boards that already have a stored solution are ignored.
+  /// Throws std::runtime_error if the record cannot be written.
+  /// </summary>
+  /// <param name="board">The solved board.</param>
+  /// <param name="moves">The moves solving the board.</param>
+  /// <returns>True if the solution was appended, False if
+  /// otherwise.</returns>
+  bool append(const Board &board, const std::vector<Move> &moves);
+
+  /// <summary>
+  /// Rewrite the store with every record sorted by key and an empty log.
+  /// Solution views taken before are invalidated. Throws std::runtime_error
+  /// if the store cannot be rewritten, leaving the previous file in place.
+  /// </summary>
+  void compact();
+
+  /// <summary>
+  /// Default getter for the number of stored solutions.
+  /// </summary>
+  std::size_t size() const noexcept;
+
+ private:
+  /// <summary>
+  /// Map the store file and index the records of its log.
+  /// </summary>
+  /// <returns>The end of the last complete record.</returns>
+  std::size_t load();
+
+  /// <summary>
+  /// Read the sorted record at an index of the offset table.
+  /// </summary>
+  std::string_view getSortedKey(std::size_t index,
+                                Solution &solution) const;
+
+  bool find(std::string_view key, Solution &solution) const;
+
+  std::string path_;
+  MappedFile mapped_;
+  std::FILE *file_{nullptr};
+  // End of the last complete record in the file
+  std::size_t end_{0};
+  // Offset table of the sorted records and the end of the sorted records
+  const std::uint8_t *sorted_{nullptr};
+  std::size_t sorted_count_{0};
+  std::size_t sorted_end_{0};
+  // Keys and moves of the log, pointing into the mapping or into appended_
+  std::unordered_map<std::string_view, Solution> index_;
+  // Records appended since the store was opened, a deque keeps them in place
+  std::deque<std::vector<std::uint8_t>> appended_;
+};
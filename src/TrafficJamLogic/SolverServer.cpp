@@ -0,0 +1,356 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "SolverServer.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace {
+// Request payload: ID, board size, main car's ID, then the cells
+constexpr std::size_t kRequestHeader = 6;
+// Response payload: ID, status, move count, then the moves
+constexpr std::size_t kResponseHeader = 7;
+// Largest payload accepted, enough for a 16x16 board
+constexpr std::uint32_t kMaxPayload = 1 << 16;
+
+std::system_error lastError(const char *what) {
+  return std::system_error{errno, std::generic_category(), what};
+}
+
+void putU16(std::vector<std::uint8_t> &out, std::uint32_t value) {
+  out.push_back(static_cast<std::uint8_t>(value));
+  out.push_back(static_cast<std::uint8_t>(value >> 8));
+}
+
+void putU32(std::vector<std::uint8_t> &out, std::uint32_t value) {
+  putU16(out, value & 0xffff);
+  putU16(out, value >> 16);
+}
+
+std::uint32_t getU32(const std::uint8_t *in) {
+  return static_cast<std::uint32_t>(in[0]) |
+         static_cast<std::uint32_t>(in[1]) << 8 |
+         static_cast<std::uint32_t>(in[2]) << 16 |
+         static_cast<std::uint32_t>(in[3]) << 24;
+}
+
+/// <summary>
+/// Read exactly size bytes.
+/// </summary>
+/// <returns>False if the connection closed first.</returns>
+bool readAll(int fd, std::uint8_t *data, std::size_t size) {
+  while (size > 0) {
+    auto n = ::recv(fd, data, size, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+/// <summary>
+/// Write every byte of a buffer.
+/// </summary>
+/// <returns>False if the connection closed first.</returns>
+bool writeAll(int fd, const std::uint8_t *data, std::size_t size) {
+  while (size > 0) {
+    auto n = ::send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+/// <summary>
+/// Read a frame into a buffer.
+/// </summary>
+/// <returns>False if the connection closed or the frame is too large.</returns>
+bool readFrame(int fd, std::vector<std::uint8_t> &payload) {
+  std::uint8_t length[4];
+  if (!readAll(fd, length, sizeof(length))) {
+    return false;
+  }
+  const auto size = getU32(length);
+  if (size > kMaxPayload) {
+    return false;
+  }
+  payload.resize(size);
+  return readAll(fd, payload.data(), payload.size());
+}
+
+sockaddr_un getAddress(const std::string &path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    throw std::invalid_argument("Socket path is too long");
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  return address;
+}
+}  // namespace
+
+struct SolverServer::Connection {
+  explicit Connection(int fd) : fd{fd} {}
+
+  ~Connection() { ::close(this->fd); }
+
+  int fd;
+  // Responses of different workers must not interleave
+  std::mutex write_mutex;
+  // Cancelled when the client disconnects, abandoning its searches
+  AStar::CancellationToken cancellation;
+};
+
+SolverServer::SolverServer(Options options)
+    : options_{std::move(options)},
+      listen_fd_{-1},
+      stopping_{false},
+      active_readers_{0} {
+  auto address = getAddress(this->options_.path);
+
+  this->listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (this->listen_fd_ < 0) {
+    throw lastError("socket");
+  }
+  ::unlink(this->options_.path.c_str());
+  if (::bind(this->listen_fd_, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) < 0 ||
+      ::listen(this->listen_fd_, SOMAXCONN) < 0) {
+    auto error = lastError("bind");
+    ::close(this->listen_fd_);
+    throw error;
+  }
+
+  auto workers = this->options_.workers;
+  if (workers == 0) {
+    workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (std::size_t i = 0; i < workers; ++i) {
+    this->workers_.emplace_back(&SolverServer::work, this);
+  }
+}
+
+SolverServer::~SolverServer() {
+  this->stop();
+
+  {
+    std::unique_lock<std::mutex> lock{this->mutex_};
+    this->readers_done_.wait(lock,
+                             [this] { return this->active_readers_ == 0; });
+  }
+  for (auto &t : this->workers_) {
+    t.join();
+  }
+  ::close(this->listen_fd_);
+  ::unlink(this->options_.path.c_str());
+}
+
+void SolverServer::run() {
+  while (!this->stopping_) {
+    int fd = ::accept(this->listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      break;
+    }
+
+    std::lock_guard<std::mutex> lock{this->mutex_};
+    if (this->stopping_) {
+      ::close(fd);
+      break;
+    }
+    auto connection = std::make_shared<Connection>(fd);
+    this->connections_.emplace_back(connection);
+    ++this->active_readers_;
+    std::thread{&SolverServer::read, this, std::move(connection)}.detach();
+  }
+}
+
+void SolverServer::stop() {
+  std::lock_guard<std::mutex> lock{this->mutex_};
+  if (this->stopping_.exchange(true)) {
+    return;
+  }
+
+  // Shutting the sockets down wakes up the threads blocked on them
+  ::shutdown(this->listen_fd_, SHUT_RDWR);
+  for (const auto &connection : this->connections_) {
+    ::shutdown(connection->fd, SHUT_RDWR);
+    connection->cancellation.cancel();
+  }
+  this->jobs_.clear();
+  this->jobs_ready_.notify_all();
+}
+
+void SolverServer::read(std::shared_ptr<Connection> connection) {
+  std::vector<std::uint8_t> payload{};
+  while (readFrame(connection->fd, payload) &&
+         payload.size() >= sizeof(std::uint32_t)) {
+    Job job{connection, getU32(payload.data()),
+            std::vector<std::uint8_t>(payload.begin() + 4, payload.end())};
+
+    std::lock_guard<std::mutex> lock{this->mutex_};
+    if (this->stopping_) {
+      break;
+    }
+    this->jobs_.emplace_back(std::move(job));
+    this->jobs_ready_.notify_one();
+  }
+
+  // The socket is closed once the workers drop their jobs for it
+  connection->cancellation.cancel();
+  std::lock_guard<std::mutex> lock{this->mutex_};
+  this->connections_.erase(std::find(this->connections_.begin(),
+                                     this->connections_.end(), connection));
+  --this->active_readers_;
+  this->readers_done_.notify_all();
+}
+
+void SolverServer::work() {
+  // Each worker keeps the memory of its searches between requests
+  AStar::Workspace workspace{};
+  std::vector<int> cells{};
+  std::vector<std::uint8_t> response{};
+
+  while (true) {
+    Job job{};
+    {
+      std::unique_lock<std::mutex> lock{this->mutex_};
+      this->jobs_ready_.wait(lock, [this] {
+        return this->stopping_ || !this->jobs_.empty();
+      });
+      if (this->stopping_) {
+        return;
+      }
+      job = std::move(this->jobs_.front());
+      this->jobs_.pop_front();
+    }
+
+    // The moves are written straight from the search's states, the move
+    // count is filled in once they are written
+    response.clear();
+    putU32(response, 0);
+    putU32(response, job.id);
+    response.push_back(static_cast<std::uint8_t>(Status::Invalid));
+    putU16(response, 0);
+
+    const auto &request = job.payload;
+    const std::size_t size = request.size() >= 2 ? request[0] : 0;
+    AStar::Options options = this->options_.search;
+    options.cancellation = job.connection->cancellation;
+    if (size > 0 && request.size() == 2 + size * size) {
+      cells.assign(request.begin() + 2, request.end());
+      try {
+        const Board board{cells, request[1]};
+        auto solution = AStar::searchRange(board, options, workspace);
+        const auto status =
+            solution.empty() ? Status::Unsolvable : Status::Solved;
+        // The first board is the request's, every later board records the
+        // move that produced it
+        std::uint32_t count = 0;
+        for (auto it = solution.begin(); it != solution.end(); ++it) {
+          if (it == solution.begin()) {
+            continue;
+          }
+          const Move &move = it->getLastMove();
+          response.push_back(static_cast<std::uint8_t>(move.car_id));
+          response.push_back(static_cast<std::uint8_t>(move.delta));
+          ++count;
+        }
+        response[8] = static_cast<std::uint8_t>(status);
+        response[9] = static_cast<std::uint8_t>(count);
+        response[10] = static_cast<std::uint8_t>(count >> 8);
+      } catch (const AStar::SearchCancelled &) {
+        continue;
+      } catch (const std::exception &) {
+        // A board without its main car, or with overlapping cars
+      }
+    }
+
+    const auto length = static_cast<std::uint32_t>(response.size() - 4);
+    for (auto i = 0; i < 4; ++i) {
+      response[i] = static_cast<std::uint8_t>(length >> (8 * i));
+    }
+
+    std::lock_guard<std::mutex> lock{job.connection->write_mutex};
+    writeAll(job.connection->fd, response.data(), response.size());
+  }
+}
+
+SolverClient::SolverClient(const std::string &path) : fd_{-1} {
+  auto address = getAddress(path);
+
+  this->fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (this->fd_ < 0) {
+    throw lastError("socket");
+  }
+  if (::connect(this->fd_, reinterpret_cast<sockaddr *>(&address),
+                sizeof(address)) < 0) {
+    auto error = lastError("connect");
+    ::close(this->fd_);
+    throw error;
+  }
+}
+
+SolverClient::~SolverClient() { ::close(this->fd_); }
+
+void SolverClient::send(std::uint32_t id, const Board &board) {
+  const auto &cells = board.getGameBoard();
+  std::vector<std::uint8_t> frame{};
+  frame.reserve(4 + kRequestHeader + cells.size());
+  putU32(frame, static_cast<std::uint32_t>(kRequestHeader + cells.size()));
+  putU32(frame, id);
+  frame.push_back(static_cast<std::uint8_t>(board.getBoardSize()));
+  frame.push_back(static_cast<std::uint8_t>(board.getMainId()));
+  for (const auto &c : cells) {
+    frame.push_back(static_cast<std::uint8_t>(c));
+  }
+
+  if (!writeAll(this->fd_, frame.data(), frame.size())) {
+    throw lastError("send");
+  }
+}
+
+SolverClient::Response SolverClient::receive() {
+  std::vector<std::uint8_t> payload{};
+  if (!readFrame(this->fd_, payload) || payload.size() < kResponseHeader) {
+    throw std::runtime_error("Connection closed");
+  }
+
+  Response response{getU32(payload.data()),
+                    static_cast<SolverServer::Status>(payload[4]),
+                    {}};
+  const std::size_t count = payload[5] | payload[6] << 8;
+  if (payload.size() != kResponseHeader + 2 * count) {
+    throw std::runtime_error("Malformed response");
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    response.moves.emplace_back(
+        payload[kResponseHeader + 2 * i],
+        static_cast<std::int8_t>(payload[kResponseHeader + 2 * i + 1]));
+  }
+  return response;
+}
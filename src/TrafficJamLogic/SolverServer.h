@@ -0,0 +1,142 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "AStar.h"
+#include "Board.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// A long-lived solver listening on a Unix domain socket (POSIX only).
+/// Every message is a frame of a 32-bit little-endian payload length
+/// followed by the payload.
+/// A request payload holds a 32-bit request ID, the board size, the main
+/// car's ID and one byte per cell, row by row.
+/// A response payload holds the request ID, a Status byte, a 16-bit move
+/// count and 2 bytes per move: the car ID and the signed delta.
+/// Clients may send many requests without waiting, responses come back as
+/// soon as each board is solved and carry the ID of their request.
+/// Requests are solved by a pool of workers, each reusing its own
+/// AStar::Workspace across requests. The searches of a client that
+/// disconnects are cancelled.
+/// </summary>
+class SolverServer {
+ public:
+  enum class Status : std::uint8_t { Solved = 0, Unsolvable = 1, Invalid = 2 };
+
+  struct Options {
+    /// <summary>
+    /// The path of the socket, replaced if it exists.
+    /// </summary>
+    std::string path{};
+
+    /// <summary>
+    /// The number of worker threads, 0 for one per hardware thread.
+    /// </summary>
+    std::size_t workers{0};
+
+    /// <summary>
+    /// Options for every search.
+    /// </summary>
+    AStar::Options search{};
+  };
+
+  /// <summary>
+  /// A constructor for creating a server listening on a socket and starting
+  /// its workers. Throws std::system_error if the socket cannot be created.
+  /// </summary>
+  explicit SolverServer(Options options);
+
+  /// <summary>
+  /// Stops the server and waits for its threads.
+  /// </summary>
+  ~SolverServer();
+
+  SolverServer(const SolverServer &) = delete;
+  SolverServer &operator=(const SolverServer &) = delete;
+
+  /// <summary>
+  /// Accept connections until stop() is called. The server must outlive the
+  /// call.
+  /// </summary>
+  void run();
+
+  /// <summary>
+  /// Stop accepting connections and close the open ones. Safe to call from
+  /// any thread.
+  /// </summary>
+  void stop();
+
+ private:
+  struct Connection;
+
+  struct Job {
+    std::shared_ptr<Connection> connection;
+    std::uint32_t id;
+    std::vector<std::uint8_t> payload;
+  };
+
+  void read(std::shared_ptr<Connection> connection);
+
+  void work();
+
+  Options options_;
+  int listen_fd_;
+  std::atomic<bool> stopping_;
+
+  std::mutex mutex_;
+  std::condition_variable jobs_ready_;
+  std::deque<Job> jobs_;
+  std::vector<std::shared_ptr<Connection>> connections_;
+  std::size_t active_readers_;
+  std::condition_variable readers_done_;
+  std::vector<std::thread> workers_;
+};
+
+/// <summary>
+/// A client for a SolverServer.
+/// </summary>
+class SolverClient {
+ public:
+  struct Response {
+    std::uint32_t id;
+    SolverServer::Status status;
+    std::vector<Move> moves;
+  };
+
+  /// <summary>
+  /// A constructor for connecting to a server. Throws std::system_error if
+  /// the connection fails.
+  /// </summary>
+  explicit SolverClient(const std::string &path);
+
+  ~SolverClient();
+
+  SolverClient(const SolverClient &) = delete;
+  SolverClient &operator=(const SolverClient &) = delete;
+
+  /// <summary>
+  /// Send a board to solve without waiting for the response.
+  /// </summary>
+  void send(std::uint32_t id, const Board &board);
+
+  /// <summary>
+  /// Wait for the next response. Throws std::runtime_error if the server
+  /// closed the connection.
+  /// </summary>
+  Response receive();
+
+ private:
+  int fd_;
+};
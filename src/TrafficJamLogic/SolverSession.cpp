@@ -0,0 +1,127 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "SolverSession.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+// Boards of known solutions kept before the session forgets them
+constexpr std::size_t kMaxKnownBoards = std::size_t{1} << 16;
+}  // namespace
+
+SolverSession::SolverSession(const Board &board, const AStar::Options &options)
+    : options_{options},
+      packed_{false},
+      board_{std::make_shared<Board>(board)},
+      search_count_{0} {
+  // Boards a Layout cannot pack are solved from scratch after every move
+  try {
+    this->layout_ = Layout{board};
+    this->packed_ = true;
+  } catch (const std::invalid_argument &) {
+  }
+
+  this->solve();
+}
+
+const Board &SolverSession::getBoard() const noexcept { return *this->board_; }
+
+const std::vector<std::shared_ptr<Board>> &SolverSession::getSolution()
+    const noexcept {
+  return this->solution_;
+}
+
+Move SolverSession::getHint() const {
+  if (this->solution_.size() < 2) {
+    return Move{};
+  }
+  return this->solution_[0]->getMoveTo(*this->solution_[1]);
+}
+
+const std::vector<std::shared_ptr<Board>> &SolverSession::applyMove(
+    const Move &move) {
+  // A player may slide a car any number of free cells
+  Board::GenerationOptions generation{};
+  generation.slide = true;
+  auto states = this->board_->getPossibleStates(generation);
+  auto next =
+      std::find_if(states.begin(), states.end(),
+                   [&move](const Board &s) { return s.getLastMove() == move; });
+  if (next == states.end()) {
+    throw std::invalid_argument("Illegal move");
+  }
+
+  // The new board is the root of the next search, the player's move must not
+  // prune its successors
+  this->board_ = std::make_shared<Board>(std::move(*next));
+  this->board_->clearLastMove();
+  this->solve();
+  return this->solution_;
+}
+
+std::size_t SolverSession::getSearchCount() const noexcept {
+  return this->search_count_;
+}
+
+void SolverSession::solve() {
+  if (!this->packed_) {
+    ++this->search_count_;
+    this->solution_ = AStar::search(*this->board_, this->options_);
+    return;
+  }
+
+  // Search only up to a board on a known solution unless the current board
+  // is one of them
+  std::vector<std::shared_ptr<Board>> path{this->board_};
+  if (this->known_.count(this->layout_.encode(*this->board_)) == 0) {
+    // A long game off the known solutions would keep every board searched
+    // to, start over once there are too many of them
+    if (this->known_.size() >= kMaxKnownBoards) {
+      this->known_.clear();
+    }
+    ++this->search_count_;
+    AStar::Options options = this->options_;
+    options.known_cost = [this](const Board &board) {
+      auto it = this->known_.find(this->layout_.encode(board));
+      return it == this->known_.end() ? -1 : it->second.cost;
+    };
+    path = AStar::search(*this->board_, options);
+    if (path.empty()) {
+      this->solution_.clear();
+      return;
+    }
+  }
+
+  // Continue the path along the known boards
+  for (auto it = this->known_.find(this->layout_.encode(*path.back()));
+       it != this->known_.end() && it->second.next != nullptr;
+       it = this->known_.find(this->layout_.encode(*path.back()))) {
+    path.emplace_back(it->second.next);
+  }
+
+  this->record(path);
+  this->solution_ = std::move(path);
+}
+
+void SolverSession::record(const std::vector<std::shared_ptr<Board>> &path) {
+  // Costs add up from the solved board backwards
+  int cost = 0;
+  for (auto i = path.size(); i-- > 0;) {
+    if (i + 1 < path.size()) {
+      cost += this->getCost(*path[i], *path[i + 1]);
+    }
+    auto next = i + 1 < path.size() ? path[i + 1] : nullptr;
+    this->known_.emplace(this->layout_.encode(*path[i]), Known{cost, next});
+  }
+}
+
+int SolverSession::getCost(const Board &from, const Board &to) const {
+  if (this->options_.cost == AStar::Options::Cost::Slides) {
+    return 1;
+  }
+  return std::abs(from.getMoveTo(to).delta);
+}
@@ -0,0 +1,85 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "AStar.h"
+#include "Board.h"
+#include "Layout.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// A solver that follows a game as the player moves.
+/// Every board on a solution found so far is kept with its cost to the goal
+/// and the next board towards it. A move along a known solution needs no
+/// search at all, any other move searches only until it reaches a known
+/// board. The known boards are forgotten once there are 65536 of them.
+/// </summary>
+class SolverSession {
+ public:
+  /// <summary>
+  /// A constructor for creating a session and solving its first board.
+  /// </summary>
+  /// <param name="board">The board the game starts from.</param>
+  /// <param name="options">Options for the searches of the session. Known
+  /// costs are exact only with a weight of 1.</param>
+  explicit SolverSession(const Board &board,
+                         const AStar::Options &options = {});
+
+  /// <summary>
+  /// Default getter for the current board.
+  /// </summary>
+  const Board &getBoard() const noexcept;
+
+  /// <summary>
+  /// Default getter for the solution from the current board.
+  /// </summary>
+  /// <returns>The boards from the current board to the solved board, empty if
+  /// the board cannot be solved.</returns>
+  const std::vector<std::shared_ptr<Board>> &getSolution() const noexcept;
+
+  /// <summary>
+  /// Get the next move of the solution.
+  /// </summary>
+  /// <returns>The next move, an empty move if the board is solved or cannot
+  /// be solved.</returns>
+  Move getHint() const;
+
+  /// <summary>
+  /// Apply a move of the player and solve the new board.
+  /// Throws std::invalid_argument if the move is not a legal move of the
+  /// current board.
+  /// </summary>
+  /// <returns>The solution from the new board.</returns>
+  const std::vector<std::shared_ptr<Board>> &applyMove(const Move &move);
+
+  /// <summary>
+  /// Default getter for the number of searches run by the session.
+  /// </summary>
+  std::size_t getSearchCount() const noexcept;
+
+ private:
+  void solve();
+
+  void record(const std::vector<std::shared_ptr<Board>> &path);
+
+  int getCost(const Board &from, const Board &to) const;
+
+  struct Known {
+    int cost;
+    std::shared_ptr<Board> next;
+  };
+
+  AStar::Options options_;
+  Layout layout_;
+  bool packed_;
+  std::shared_ptr<Board> board_;
+  std::vector<std::shared_ptr<Board>> solution_;
+  std::unordered_map<std::uint64_t, Known> known_;
+  std::size_t search_count_;
+};
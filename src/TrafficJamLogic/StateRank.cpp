@@ -0,0 +1,91 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "StateRank.h"
+
+#include <algorithm>
+
+namespace {
+// Lanes hold at most kMaxBoardSize free cells plus kMaxCars cars
+constexpr int kMaxN = Layout::kMaxBoardSize + Layout::kMaxCars;
+}  // namespace
+
+StateRank::StateRank(const Layout &layout) : layout_{&layout} {
+  this->binomials_.assign((kMaxN + 1) * (Layout::kMaxCars + 1), 0);
+  for (auto n = 0; n <= kMaxN; ++n) {
+    this->binomials_[static_cast<std::size_t>(n) * (Layout::kMaxCars + 1)] = 1;
+    for (auto k = 1; k <= std::min(n, Layout::kMaxCars); ++k) {
+      this->binomials_[static_cast<std::size_t>(n) * (Layout::kMaxCars + 1) +
+                       k] = this->binomial(n - 1, k - 1) +
+                            (k <= n - 1 ? this->binomial(n - 1, k) : 0);
+    }
+  }
+
+  // Layout cars are sorted by lane, so each lane is a run of cars
+  for (auto i = 0; i < layout.getCarCount(); ++i) {
+    if (this->lanes_.empty() ||
+        layout.getDirection(i) !=
+            layout.getDirection(this->lanes_.back().first) ||
+        layout.getLane(i) != layout.getLane(this->lanes_.back().first)) {
+      this->lanes_.push_back(Lane{i, 0, layout.getBoardSize(), 0});
+    }
+    ++this->lanes_.back().count;
+    this->lanes_.back().free -= layout.getLength(i);
+  }
+
+  for (auto &lane : this->lanes_) {
+    lane.size = this->binomial(lane.free + lane.count, lane.count);
+    this->size_ *= lane.size;
+  }
+}
+
+std::uint64_t StateRank::rank(std::uint64_t state) const noexcept {
+  std::uint64_t rank = 0;
+
+  for (const auto &lane : this->lanes_) {
+    // The free cells before each car never decrease along the lane, adding
+    // the car's index makes them a strictly increasing combination
+    std::uint64_t lane_rank = 0;
+    int covered = 0;
+    for (auto k = 0; k < lane.count; ++k) {
+      auto i = lane.first + k;
+      auto combination = Layout::getPosition(state, i) - covered + k;
+      lane_rank += this->binomial(combination, k + 1);
+      covered += this->layout_->getLength(i);
+    }
+    rank = rank * lane.size + lane_rank;
+  }
+
+  return rank;
+}
+
+std::uint64_t StateRank::unrank(std::uint64_t rank) const noexcept {
+  std::uint64_t state = 0;
+
+  for (auto it = this->lanes_.rbegin(); it != this->lanes_.rend(); ++it) {
+    const auto &lane = *it;
+    auto lane_rank = rank % lane.size;
+    rank /= lane.size;
+
+    // Covered cells before each car, to turn combinations back into positions
+    int covered[Layout::kMaxCars + 1] = {0};
+    for (auto k = 0; k < lane.count; ++k) {
+      covered[k + 1] = covered[k] + this->layout_->getLength(lane.first + k);
+    }
+
+    auto combination = lane.free + lane.count;
+    for (auto k = lane.count - 1; k >= 0; --k) {
+      do {
+        --combination;
+      } while (this->binomial(combination, k + 1) > lane_rank);
+      lane_rank -= this->binomial(combination, k + 1);
+      state = Layout::setPosition(state, lane.first + k,
+                                  combination - k + covered[k]);
+    }
+  }
+
+  return state;
+}
+
+std::uint64_t StateRank::getSize() const noexcept { return this->size_; }
@@ -0,0 +1,68 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "Layout.h"
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// A perfect ranking of the states of a layout.
+/// Cars sharing a lane can never pass each other, so the placements of a
+/// lane are ranked as a combination of its free cells and the lane ranks are
+/// combined as a mixed-radix number. Every state whose cars do not overlap
+/// within a lane gets a distinct rank in [0, getSize()), which makes the rank
+/// usable as an index into flat visited and distance arrays.
+/// </summary>
+class StateRank {
+ public:
+  /// <summary>
+  /// A constructor for creating the ranking of a layout.
+  /// </summary>
+  /// <param name="layout">The layout to rank the states of. The layout must
+  /// outlive the ranking.</param>
+  explicit StateRank(const Layout &layout);
+
+  /// <summary>
+  /// Default constructor.
+  /// </summary>
+  StateRank() = default;
+
+  /// <summary>
+  /// Map a state to its rank.
+  /// </summary>
+  std::uint64_t rank(std::uint64_t state) const noexcept;
+
+  /// <summary>
+  /// Map a rank back to its state.
+  /// </summary>
+  std::uint64_t unrank(std::uint64_t rank) const noexcept;
+
+  /// <summary>
+  /// Default getter for the number of ranks.
+  /// </summary>
+  std::uint64_t getSize() const noexcept;
+
+ private:
+  struct Lane {
+    // Index of the lane's first car in the layout
+    int first;
+    int count;
+    // Number of cells not covered by the lane's cars
+    int free;
+    std::uint64_t size;
+  };
+
+  std::uint64_t binomial(int n, int k) const noexcept {
+    return this->binomials_[static_cast<std::size_t>(n) * (Layout::kMaxCars + 1) +
+                            k];
+  }
+
+  const Layout *layout_{nullptr};
+  std::vector<Lane> lanes_;
+  std::vector<std::uint64_t> binomials_;
+  std::uint64_t size_{1};
+};
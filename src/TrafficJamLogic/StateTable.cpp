@@ -0,0 +1,80 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "StateTable.h"
+
+#include <algorithm>
+
+StateTable::StateTable(std::size_t capacity) {
+  // Keep the table at most half full
+  std::size_t buckets = 16;
+  while (buckets < 2 * capacity) {
+    buckets *= 2;
+  }
+
+  this->keys_.assign(buckets, 0);
+  this->ids_.assign(buckets, kNone);
+  this->mask_ = buckets - 1;
+
+  this->states_.reserve(capacity);
+  this->g_values_.reserve(capacity);
+  this->parents_.reserve(capacity);
+}
+
+std::uint32_t StateTable::find(std::uint64_t key) const noexcept {
+  for (auto bucket = this->getBucket(key);;
+       bucket = (bucket + 1) & this->mask_) {
+    if (this->ids_[bucket] == kNone || this->keys_[bucket] == key) {
+      return this->ids_[bucket];
+    }
+  }
+}
+
+std::pair<std::uint32_t, bool> StateTable::insert(std::uint64_t key) {
+  if (2 * (this->states_.size() + 1) > this->keys_.size()) {
+    this->grow();
+  }
+
+  auto bucket = this->getBucket(key);
+  for (; this->ids_[bucket] != kNone; bucket = (bucket + 1) & this->mask_) {
+    if (this->keys_[bucket] == key) {
+      return {this->ids_[bucket], false};
+    }
+  }
+
+  const auto index = static_cast<std::uint32_t>(this->states_.size());
+  this->keys_[bucket] = key;
+  this->ids_[bucket] = index;
+  this->states_.emplace_back(key);
+  this->g_values_.emplace_back(0);
+  this->parents_.emplace_back(kNone);
+
+  return {index, true};
+}
+
+void StateTable::clear() noexcept {
+  std::fill(this->ids_.begin(), this->ids_.end(), kNone);
+  this->states_.clear();
+  this->g_values_.clear();
+  this->parents_.clear();
+}
+
+std::size_t StateTable::size() const noexcept { return this->states_.size(); }
+
+void StateTable::grow() {
+  const std::size_t buckets = 2 * this->keys_.size();
+  this->keys_.assign(buckets, 0);
+  this->ids_.assign(buckets, kNone);
+  this->mask_ = buckets - 1;
+
+  // The states array already holds every key in index order
+  for (std::uint32_t i = 0; i < this->states_.size(); ++i) {
+    auto bucket = this->getBucket(this->states_[i]);
+    while (this->ids_[bucket] != kNone) {
+      bucket = (bucket + 1) & this->mask_;
+    }
+    this->keys_[bucket] = this->states_[i];
+    this->ids_[bucket] = i;
+  }
+}
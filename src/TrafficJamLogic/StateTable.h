@@ -0,0 +1,133 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+/// <summary>
+/// An open-addressing hash table of packed 64-bit states.
+/// Buckets hold only a key and the state's dense index, probed linearly, so a
+/// lookup touches one or two cache lines instead of following list nodes.
+/// States are numbered in insertion order, and their g values and parent
+/// indices live in parallel arrays indexed by that number.
+/// </summary>
+class StateTable {
+ public:
+  /// <summary>
+  /// The index of a missing state, also the parent index of the start.
+  /// </summary>
+  static constexpr std::uint32_t kNone = UINT32_MAX;
+
+  /// <summary>
+  /// A constructor for creating an empty table.
+  /// </summary>
+  /// <param name="capacity">The number of states to reserve room for.</param>
+  explicit StateTable(std::size_t capacity = 1024);
+
+  /// <summary>
+  /// Prefetch the bucket a key hashes to, so that a later find or insert of
+  /// the key does not wait for memory.
+  /// </summary>
+  void prefetch(std::uint64_t key) const noexcept {
+    const std::size_t bucket = this->getBucket(key);
+#if defined(_MSC_VER)
+    _mm_prefetch(reinterpret_cast<const char *>(&this->keys_[bucket]),
+                 _MM_HINT_T0);
+    _mm_prefetch(reinterpret_cast<const char *>(&this->ids_[bucket]),
+                 _MM_HINT_T0);
+#else
+    __builtin_prefetch(&this->keys_[bucket]);
+    __builtin_prefetch(&this->ids_[bucket]);
+#endif
+  }
+
+  /// <summary>
+  /// Find the index of a state.
+  /// </summary>
+  /// <returns>The index of the state, kNone if the state is missing.</returns>
+  std::uint32_t find(std::uint64_t key) const noexcept;
+
+  /// <summary>
+  /// Insert a state unless it is already in the table.
+  /// A new state starts with a g value of 0 and no parent.
+  /// </summary>
+  /// <returns>The index of the state, and true if the state was
+  /// inserted.</returns>
+  std::pair<std::uint32_t, bool> insert(std::uint64_t key);
+
+  /// <summary>
+  /// Remove every state, keeping the memory of the table.
+  /// </summary>
+  void clear() noexcept;
+
+  /// <summary>
+  /// Default getter for the key of a state.
+  /// </summary>
+  std::uint64_t getKey(std::uint32_t index) const noexcept {
+    return this->states_[index];
+  }
+
+  /// <summary>
+  /// Default getter for the g value of a state.
+  /// </summary>
+  int getGValue(std::uint32_t index) const noexcept {
+    return this->g_values_[index];
+  }
+
+  /// <summary>
+  /// Default setter for the g value of a state.
+  /// </summary>
+  void setGValue(std::uint32_t index, int g_value) noexcept {
+    this->g_values_[index] = g_value;
+  }
+
+  /// <summary>
+  /// Default getter for the parent index of a state.
+  /// </summary>
+  std::uint32_t getParent(std::uint32_t index) const noexcept {
+    return this->parents_[index];
+  }
+
+  /// <summary>
+  /// Default setter for the parent index of a state.
+  /// </summary>
+  void setParent(std::uint32_t index, std::uint32_t parent) noexcept {
+    this->parents_[index] = parent;
+  }
+
+  /// <summary>
+  /// Default getter for the number of states.
+  /// </summary>
+  std::size_t size() const noexcept;
+
+ private:
+  std::size_t getBucket(std::uint64_t key) const noexcept {
+    // Finalizer of splitmix64, packed states differ in few low bits
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9u;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebu;
+    key ^= key >> 31;
+    return static_cast<std::size_t>(key) & this->mask_;
+  }
+
+  void grow();
+
+  // Buckets, an empty bucket has the index kNone
+  std::vector<std::uint64_t> keys_;
+  std::vector<std::uint32_t> ids_;
+  std::size_t mask_;
+
+  // States in insertion order
+  std::vector<std::uint64_t> states_;
+  std::vector<int> g_values_;
+  std::vector<std::uint32_t> parents_;
+};
@@ -0,0 +1,110 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "Symmetry.h"
+
+#include <algorithm>
+
+namespace {
+Symmetry::CanonicalBoard relabel(const Board &board) {
+  Symmetry::CanonicalBoard canonical{};
+  const int size = board.getBoardSize();
+  const int main_id = board.getMainId();
+  std::vector<int> game_board(board.getGameBoard().size());
+  int next_id = 1;
+
+  canonical.to_canonical.emplace(0, 0);
+  canonical.to_canonical.emplace(main_id, main_id);
+
+  for (auto i = 0; i < size; ++i) {
+    for (auto j = 0; j < size; ++j) {
+      auto id = board.getGameBoardAt(i, j);
+      auto it = canonical.to_canonical.find(id);
+
+      if (it == canonical.to_canonical.end()) {
+        if (next_id == main_id) {
+          ++next_id;
+        }
+        it = canonical.to_canonical.emplace(id, next_id++).first;
+      }
+
+      game_board[static_cast<uint64_t>(i) * static_cast<uint64_t>(size) + j] =
+          it->second;
+    }
+  }
+
+  canonical.to_canonical.erase(0);
+  for (const auto &ids : canonical.to_canonical) {
+    canonical.to_original.emplace(ids.second, ids.first);
+  }
+  canonical.board = Board{game_board, main_id};
+
+  return canonical;
+}
+
+std::vector<Move> mapMoves(const Symmetry::CanonicalBoard &canonical,
+                           const std::vector<Move> &moves, bool to_canonical) {
+  std::vector<Move> mapped{};
+  mapped.reserve(moves.size());
+
+  for (const auto &move : moves) {
+    auto canonical_id = to_canonical ? canonical.to_canonical.at(move.car_id)
+                                     : move.car_id;
+    auto delta = move.delta;
+    // Flipping rows reverses the direction of vertical moves
+    if (canonical.mirrored &&
+        canonical.board.getCar(canonical_id).getDirection() ==
+            Car::Direction::Vertical) {
+      delta = -delta;
+    }
+    mapped.emplace_back(
+        to_canonical ? canonical_id : canonical.to_original.at(move.car_id),
+        delta);
+  }
+
+  return mapped;
+}
+}  // namespace
+
+Board Symmetry::mirror(const Board &board) {
+  const int size = board.getBoardSize();
+  const auto &game_board = board.getGameBoard();
+  std::vector<int> mirrored(game_board.size());
+
+  for (auto i = 0; i < size; ++i) {
+    std::copy(game_board.begin() + static_cast<int64_t>(i) * size,
+              game_board.begin() + static_cast<int64_t>(i + 1) * size,
+              mirrored.begin() + static_cast<int64_t>(size - i - 1) * size);
+  }
+
+  return Board{mirrored, board.getMainId()};
+}
+
+Symmetry::CanonicalBoard Symmetry::canonicalize(const Board &board,
+                                                bool fold_mirror) {
+  auto canonical = relabel(board);
+
+  // Mirroring keeps a horizontal main car in its row's column range, so the
+  // mirrored board reaches the goal in the same number of moves
+  if (fold_mirror &&
+      board.getMainCar().getDirection() == Car::Direction::Horizontal) {
+    auto mirrored = relabel(mirror(board));
+    if (mirrored.board < canonical.board) {
+      mirrored.mirrored = true;
+      return mirrored;
+    }
+  }
+
+  return canonical;
+}
+
+std::vector<Move> Symmetry::toCanonical(const CanonicalBoard &canonical,
+                                        const std::vector<Move> &moves) {
+  return mapMoves(canonical, moves, true);
+}
+
+std::vector<Move> Symmetry::toOriginal(const CanonicalBoard &canonical,
+                                       const std::vector<Move> &moves) {
+  return mapMoves(canonical, moves, false);
+}
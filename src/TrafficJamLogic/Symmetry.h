@@ -0,0 +1,64 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#pragma once
+
+#include "Board.h"
+#include "Move.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Symmetry {
+struct CanonicalBoard {
+  /// <summary>
+  /// The relabelled (and possibly mirrored) board.
+  /// </summary>
+  Board board;
+
+  /// <summary>
+  /// True if the rows of the original board were flipped.
+  /// </summary>
+  bool mirrored{false};
+
+  /// <summary>
+  /// A map of original car IDs to canonical car IDs.
+  /// </summary>
+  std::unordered_map<int, int> to_canonical;
+
+  /// <summary>
+  /// A map of canonical car IDs to original car IDs.
+  /// </summary>
+  std::unordered_map<int, int> to_original;
+};
+
+/// <summary>
+/// A function to flip the rows of a board. The goal of reaching the right
+/// edge is unaffected, so a mirrored board has the same solution length.
+/// </summary>
+Board mirror(const Board &board);
+
+/// <summary>
+/// A function to return the canonical form of a board.
+/// The main car keeps its ID, every other car is renumbered in the order its
+/// top-left cell is found scanning the board row by row. Boards that only
+/// differ in how cars are numbered have the same canonical board.
+/// </summary>
+/// <param name="board">The board to canonicalize.</param>
+/// <param name="fold_mirror">If True, the row-flipped board is also
+/// considered and the smaller of both canonical boards is returned.</param>
+CanonicalBoard canonicalize(const Board &board, bool fold_mirror = false);
+
+/// <summary>
+/// A function to map moves of an original board onto its canonical board.
+/// </summary>
+std::vector<Move> toCanonical(const CanonicalBoard &canonical,
+                              const std::vector<Move> &moves);
+
+/// <summary>
+/// A function to map moves of a canonical board back onto the original board.
+/// </summary>
+std::vector<Move> toOriginal(const CanonicalBoard &canonical,
+                             const std::vector<Move> &moves);
+}  // namespace Symmetry
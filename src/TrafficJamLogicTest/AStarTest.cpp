@@ -0,0 +1,243 @@
+#include "../TrafficJamLogic/AStar.h"
+#include "../TrafficJamLogic/Layout.h"
+#include "pch.h"
+
+class AStarTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // A puzzle with an optimal solution of 7 one-cell moves
+    board = Board{std::vector<int>{5,  5,  0, 2, 2, 2, 9,  9,  4, 4, 4, 0,
+                                   1,  1,  0, 0, 0, 6, 12, 10, 3, 3, 3, 6,
+                                   12, 10, 0, 8, 8, 11, 7, 7, 7, 0, 0, 11}};
+  }
+
+  Board board;
+};
+
+TEST_F(AStarTest, FindsShortestSolution) {
+  auto path = AStar::search(board);
+  ASSERT_EQ(path.size(), 8u);
+  ASSERT_EQ(*path.front(), board);
+  ASSERT_TRUE(path.back()->solved());
+}
+
+TEST_F(AStarTest, LazyHeuristicFindsShortestSolution) {
+  AStar::Options options{};
+  options.lazy_heuristic = true;
+  auto path = AStar::search(board, options);
+  ASSERT_EQ(path.size(), 8u);
+  ASSERT_TRUE(path.back()->solved());
+
+  options.generation.prune_transpositions = true;
+  ASSERT_EQ(AStar::search(board, options).size(), 8u);
+}
+
+TEST_F(AStarTest, PruningKeepsMovesOfStartBoard) {
+  // Every successor carries the move that produced it, the move must not
+  // prune the successors of the start
+  for (const auto slide : {false, true}) {
+    AStar::Options pruned{};
+    pruned.generation.prune_transpositions = true;
+    pruned.generation.slide = slide;
+    pruned.cost = slide ? AStar::Options::Cost::Slides
+                        : AStar::Options::Cost::Cells;
+    AStar::Options unpruned = pruned;
+    unpruned.generation.prune_transpositions = false;
+
+    for (const auto &start : board.getPossibleStates(pruned.generation)) {
+      ASSERT_NE(start.getLastMove().car_id, 0);
+      Board root{start};
+      root.clearLastMove();
+      auto expected = AStar::search(root, unpruned);
+      ASSERT_EQ(AStar::search(start, pruned).size(), expected.size());
+      ASSERT_EQ(AStar::anytimeSearch(start, pruned).size(), expected.size());
+    }
+  }
+}
+
+TEST_F(AStarTest, SearchRangeMatchesSearch) {
+  auto path = AStar::search(board);
+  auto moves = AStar::getMoves(path);
+
+  AStar::Workspace workspace{};
+  auto solution = AStar::searchRange(board, {}, workspace);
+  ASSERT_EQ(solution.size(), path.size());
+
+  std::size_t i = 0;
+  for (const auto &b : solution) {
+    ASSERT_EQ(b, *path[i]);
+    if (i > 0) {
+      ASSERT_EQ(b.getLastMove().car_id, moves[i - 1].car_id);
+      ASSERT_EQ(b.getLastMove().delta, moves[i - 1].delta);
+    }
+    ++i;
+  }
+  ASSERT_EQ(i, path.size());
+
+  // A solved board is a solution of one board
+  solution = AStar::searchRange(*path.back(), {}, workspace);
+  ASSERT_EQ(solution.size(), 1u);
+  ASSERT_TRUE(solution.begin()->solved());
+}
+
+TEST_F(AStarTest, UpdateHValueMatchesCalculateHValue) {
+  Board::GenerationOptions options{};
+  options.slide = true;
+
+  // Walk the states near the start and compare the incremental heuristic of
+  // every child with a full scan of its board
+  std::vector<std::shared_ptr<AStar::Node>> frontier{
+      std::make_shared<AStar::Node>(board)};
+  frontier.front()->h_value = AStar::calculateHValue(*frontier.front());
+  frontier.front()->h_evaluated = true;
+
+  for (auto depth = 0; depth < 3; ++depth) {
+    std::vector<std::shared_ptr<AStar::Node>> next{};
+    for (const auto &node : frontier) {
+      for (auto &child : node->getNeighbours(options)) {
+        child->h_value = AStar::updateHValue(*child);
+        child->h_evaluated = true;
+        ASSERT_EQ(child->h_value, AStar::calculateHValue(*child));
+        next.emplace_back(std::move(child));
+      }
+    }
+    frontier = std::move(next);
+  }
+}
+
+TEST_F(AStarTest, UpdateHValueLeavingGoalMatchesCalculateHValue) {
+  const auto solved = AStar::search(board).back();
+  ASSERT_TRUE(solved->solved());
+
+  Board::GenerationOptions options{};
+  options.slide = true;
+  auto main_moves = 0;
+  for (const auto &child : solved->getPossibleStates(options)) {
+    main_moves += child.getLastMove().car_id == child.getMainId();
+    ASSERT_EQ(AStar::updateHValue(child, 0), AStar::calculateHValue(child));
+  }
+  ASSERT_GT(main_moves, 0);
+}
+
+TEST_F(AStarTest, SolvesBoardsLargerThanLayout) {
+  // A 9x9 board cannot be packed into 64 bits
+  const Board large{{{1, Car(1, 4, 0, 2, Car::Direction::Horizontal)},
+                     {2, Car(2, 5, 6, 3, Car::Direction::Vertical)}},
+                    9};
+  auto path = AStar::search(large);
+  ASSERT_EQ(path.size(), 10u);
+  ASSERT_TRUE(path.back()->solved());
+}
+
+TEST_F(AStarTest, WeightedSearchFindsBoundedSolution) {
+  AStar::Options options{};
+  options.weight = 2.0;
+  auto path = AStar::search(board, options);
+  ASSERT_TRUE(path.back()->solved());
+  ASSERT_LE(path.size() - 1, 14u);
+}
+
+TEST_F(AStarTest, AnytimeSearchImprovesToShortestSolution) {
+  std::vector<std::pair<std::size_t, double>> solutions{};
+  AStar::AnytimeOptions anytime_options{};
+  anytime_options.initial_weight = 4.0;
+  auto path = AStar::anytimeSearch(
+      board, {}, anytime_options,
+      [&solutions](const std::vector<std::shared_ptr<Board>> &solution,
+                   double weight) {
+        ASSERT_TRUE(solution.back()->solved());
+        solutions.emplace_back(solution.size() - 1, weight);
+      });
+
+  ASSERT_EQ(path.size(), 8u);
+  ASSERT_FALSE(solutions.empty());
+  for (std::size_t i = 1; i < solutions.size(); ++i) {
+    ASSERT_LT(solutions[i].first, solutions[i - 1].first);
+  }
+  ASSERT_EQ(solutions.back().first, 7u);
+}
+
+TEST_F(AStarTest, AnytimeSearchStopsAtDeadline) {
+  AStar::AnytimeOptions anytime_options{};
+  anytime_options.deadline = std::chrono::steady_clock::now();
+  auto path = AStar::anytimeSearch(board, {}, anytime_options);
+  ASSERT_TRUE(path.empty() || path.back()->solved());
+}
+
+TEST_F(AStarTest, AnytimeSearchReturnsSolvedStart) {
+  const auto solved = *AStar::search(board).back();
+  std::size_t solutions = 0;
+  auto path = AStar::anytimeSearch(
+      solved, {}, {},
+      [&solutions](const std::vector<std::shared_ptr<Board>> &solution,
+                   double weight) {
+        ASSERT_EQ(solution.size(), 1u);
+        ASSERT_EQ(weight, 1.0);
+        ++solutions;
+      });
+
+  ASSERT_EQ(path.size(), 1u);
+  ASSERT_TRUE(path.back()->solved());
+  ASSERT_EQ(solutions, 1u);
+}
+
+TEST_F(AStarTest, BatchHValuesMatchHValue) {
+  // Vertical cars on an 8x8 board cross the main car's row
+  const Board large{std::vector<int>{
+      2, 0, 0, 0, 0, 0, 0, 3,
+      2, 0, 0, 0, 0, 0, 0, 3,
+      0, 0, 0, 0, 0, 0, 0, 3,
+      1, 1, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0,
+      4, 4, 4, 4, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 5,
+      0, 0, 0, 0, 0, 0, 0, 5}};
+
+  for (const auto &start : {board, large}) {
+    // A few layers of states and a solved state, more than a batch of four
+    // and not a multiple of it
+    const Layout layout{start};
+    std::vector<std::uint64_t> states{layout.encode(start)};
+    for (std::size_t i = 0; states.size() < 103; ++i) {
+      layout.getSuccessors(states[i], states);
+    }
+    states.resize(102);
+    const int main = layout.getMainIndex();
+    states.emplace_back(Layout::setPosition(
+        states[0], main,
+        layout.getBoardSize() - layout.getLength(main)));
+
+    std::vector<int> h_values(states.size());
+    AStar::calculateHValues(layout, states.data(), states.size(),
+                            h_values.data());
+    for (std::size_t i = 0; i < states.size(); ++i) {
+      ASSERT_EQ(h_values[i], AStar::calculateHValue(layout.decode(states[i])));
+    }
+    ASSERT_EQ(h_values.back(), 0);
+  }
+}
+
+TEST_F(AStarTest, AsyncSearchMatchesSearch) {
+  auto future = AStar::searchAsync(board);
+  auto path = future.get();
+  ASSERT_EQ(path.size(), 8u);
+  ASSERT_EQ(AStar::getMoves(path), AStar::getMoves(AStar::search(board)));
+}
+
+TEST_F(AStarTest, CancelledSearchThrows) {
+  // A puzzle with an optimal solution of 29 one-cell moves
+  const Board hard{std::vector<int>{3, 0, 4, 0, 8, 8,  3, 0, 4,  0, 12, 10,
+                                    1, 1, 4, 5, 12, 10, 6, 6, 6, 5, 0, 10,
+                                    7, 0, 0, 9, 9, 0,  7, 2, 2,  0, 11, 11}};
+  AStar::Options options{};
+  options.cancellation.cancel();
+  auto future = AStar::searchAsync(hard, options);
+  ASSERT_THROW(future.get(), AStar::SearchCancelled);
+
+  // Copies of a token share its flag
+  AStar::CancellationToken token{};
+  AStar::CancellationToken copy = token;
+  ASSERT_FALSE(copy.isCancelled());
+  token.cancel();
+  ASSERT_TRUE(copy.isCancelled());
+}
@@ -0,0 +1,50 @@
+#include "../TrafficJamLogic/BatchSolver.h"
+#include "../TrafficJamLogic/BitmapSearch.h"
+#include "pch.h"
+
+class BatchSolverTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    board = Board{std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0,
+                                   1, 1, 4, 0, 6, 0, 5, 5, 4, 0, 0, 7,
+                                   0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+  }
+
+  Board board;
+};
+
+TEST_F(BatchSolverTest, SolvesLayoutGroupWithSharedSearch) {
+  BatchSolver solver{BatchSolver::Options{2, std::uint64_t{1} << 30}};
+
+  // Boards along the README solution share the layout of the start board
+  auto path = BitmapSearch::search(board);
+  for (const auto &b : path) {
+    solver.add(*b);
+  }
+  // A board with another layout is solved on its own
+  const Board other{{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 1, 1, 0, 0, 2, 0,
+                     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+  auto other_index = solver.add(other);
+  ASSERT_EQ(solver.size(), path.size() + 1);
+
+  auto solutions = solver.solve();
+  ASSERT_EQ(solver.size(), 0u);
+  ASSERT_EQ(solutions.size(), path.size() + 1);
+
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    ASSERT_EQ(solutions[i].size(), path.size() - i);
+    ASSERT_TRUE(*solutions[i].front() == *path[i]);
+    ASSERT_TRUE(solutions[i].back()->solved());
+  }
+  ASSERT_TRUE(solutions[other_index].back()->solved());
+}
+
+TEST_F(BatchSolverTest, ReportsUnsolvableBoards) {
+  BatchSolver solver{BatchSolver::Options{1, std::uint64_t{1} << 30}};
+  solver.add(Board{{0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 3, 1, 1, 0, 2, 2, 2,
+                    0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0}});
+
+  auto solutions = solver.solve();
+  ASSERT_EQ(solutions.size(), 1u);
+  ASSERT_TRUE(solutions[0].empty());
+}
@@ -1,142 +1,236 @@
-#include "../TrafficJamLogic/Board.cpp"
-#include "pch.h"
-
-class BoardTest : public ::testing::Test {
- protected:
-  void SetUp() override {
-    car_1 = Car(1, 2, 0, 2, Car::Direction::Horizontal);
-    car_2 = Car(2, 4, 1, 3, Car::Direction::Horizontal);
-    car_3 = Car(3, 0, 3, 3, Car::Direction::Horizontal);
-    car_4 = Car(4, 3, 2, 3, Car::Direction::Vertical);
-    car_5 = Car(5, 3, 0, 2, Car::Direction::Horizontal);
-    car_6 = Car(6, 2, 4, 2, Car::Direction::Vertical);
-    car_7 = Car(7, 5, 5, 3, Car::Direction::Vertical);
-
-    all_cars.insert({1, car_1});
-    all_cars.insert({2, car_2});
-    all_cars.insert({3, car_3});
-    all_cars.insert({4, car_4});
-    all_cars.insert({5, car_5});
-    all_cars.insert({6, car_6});
-    all_cars.insert({7, car_7});
-
-    game_board =
-        std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0, 1, 1, 4, 0, 6, 0,
-                         5, 5, 4, 0, 0, 7, 0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7};
-  }
-
-  // void TearDown() override {}
-
-  Car car_1;
-  Car car_2;
-  Car car_3;
-  Car car_4;
-  Car car_5;
-  Car car_6;
-  Car car_7;
-  std::unordered_map<int, Car> all_cars{};
-  std::vector<int> game_board{};
-};
-
-TEST_F(BoardTest, ConstructorMap) {
-  const Board board{all_cars};
-
-  ASSERT_EQ(board.getGameBoard(), game_board);
-  ASSERT_EQ(board.getCars(), all_cars);
-  ASSERT_EQ(board.getBoardSize(), 6);
-  ASSERT_EQ(board.getMainId(), 1);
-}
-
-TEST_F(BoardTest, ConstructorVector) {
-  const Board board{game_board};
-
-  ASSERT_EQ(board.getGameBoard(), game_board);
-  ASSERT_EQ(board.getCars(), all_cars);
-  ASSERT_EQ(board.getBoardSize(), 6);
-  ASSERT_EQ(board.getMainId(), 1);
-}
-
-TEST_F(BoardTest, EqualToOperator) {
-  Board board_1{game_board};
-  const Board board_2{all_cars};
-  Board board_3{{0, 0, 0, 0, 3, 3, 0, 0, 4, 0, 6, 0, 1, 1, 4, 0, 6, 0,
-                 5, 5, 4, 0, 0, 7, 0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
-
-  ASSERT_TRUE(board_1 == board_2);
-  ASSERT_TRUE(board_2 == board_1);
-  ASSERT_FALSE(board_1 == board_3);
-  ASSERT_FALSE(board_3 == board_2);
-}
-
-TEST_F(BoardTest, TestSolvedMethod) {
-  // Normal board unsolved state
-  const Board board_1{game_board};
-
-  ASSERT_EQ(board_1.getMainId(), 1);
-  ASSERT_FALSE(board_1.solved());
-
-  // 1 car solved state
-  const Board board_2{{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1,
-                       0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
-
-  ASSERT_EQ(board_2.getMainId(), 1);
-  ASSERT_TRUE(board_2.solved());
-
-  // 1 car with id 2 solved state
-  const Board board_3{{0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2,
-                       0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-                      2};
-
-  ASSERT_EQ(board_3.getMainId(), 2);
-  ASSERT_TRUE(board_3.solved());
-}
-
-TEST_F(BoardTest, TestGetGameBoardAtMethod) {
-  const Board board{game_board};
-
-  ASSERT_EQ(board.getGameBoardAt(0, 0), 0);
-  ASSERT_EQ(board.getGameBoardAt(3, 2), 4);
-  ASSERT_EQ(board.getGameBoardAt(5, 5), 7);
-  ASSERT_EQ(board.getGameBoardAt(4, 1), 2);
-  ASSERT_NE(board.getGameBoardAt(5, 1), 3);
-  ASSERT_NE(board.getGameBoardAt(1, 1), 6);
-  ASSERT_NE(board.getGameBoardAt(2, 1), 3);
-}
-
-TEST_F(BoardTest, TestSetGameBoardAtMethod) {
-  Board board{game_board};
-
-  ASSERT_EQ(board.getGameBoardAt(0, 0), 0);
-  board.setGameBoardAt(0, 0, 4);
-  ASSERT_EQ(board.getGameBoardAt(0, 0), 4);
-}
-
-TEST_F(BoardTest, TestGetMainCarMethod) {
-  Board board{game_board};
-
-  ASSERT_EQ(board.getMainId(), 1);
-  ASSERT_EQ(board.getMainCar().getId(), 1);
-  ASSERT_EQ(board.getMainCar(), Car(1, 2, 0, 2, Car::Direction::Horizontal));
-}
-
-TEST_F(BoardTest, TestGetPossibleStatesMethod) {
-  Board board{game_board};
-
-  auto states = board.getPossibleStates();
-  std::ostringstream oss{};
-
-  for (const auto &state : states) {
-    oss << state << '\n';
-  }
-
-  auto output = oss.str();
-  auto expected =
-      "003330\n004060\n114060\n554007\n022207\n000007\n\n000333\n004060\n114060"
-      "\n5540"
-      "07\n222007\n000007\n\n000333\n004060\n114060\n554007\n002227\n000007\n\n"
-      "004333"
-      "\n004060\n114060\n550007\n022207\n000007\n\n000333\n004000\n114060\n5540"
-      "67\n02"
-      "2207\n000007\n\n000333\n004060\n114067\n554007\n022207\n000000\n\n";
-  ASSERT_EQ(output, expected);
-}
+#include <algorithm>
+#include <sstream>
+#include "../TrafficJamLogic/AStar.h"
+#include "../TrafficJamLogic/Board.h"
+#include "pch.h"
+
+class BoardTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    car_1 = Car(1, 2, 0, 2, Car::Direction::Horizontal);
+    car_2 = Car(2, 4, 1, 3, Car::Direction::Horizontal);
+    car_3 = Car(3, 0, 3, 3, Car::Direction::Horizontal);
+    car_4 = Car(4, 3, 2, 3, Car::Direction::Vertical);
+    car_5 = Car(5, 3, 0, 2, Car::Direction::Horizontal);
+    car_6 = Car(6, 2, 4, 2, Car::Direction::Vertical);
+    car_7 = Car(7, 5, 5, 3, Car::Direction::Vertical);
+
+    all_cars.insert({1, car_1});
+    all_cars.insert({2, car_2});
+    all_cars.insert({3, car_3});
+    all_cars.insert({4, car_4});
+    all_cars.insert({5, car_5});
+    all_cars.insert({6, car_6});
+    all_cars.insert({7, car_7});
+
+    game_board =
+        std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0, 1, 1, 4, 0, 6, 0,
+                         5, 5, 4, 0, 0, 7, 0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7};
+  }
+
+  // void TearDown() override {}
+
+  Car car_1;
+  Car car_2;
+  Car car_3;
+  Car car_4;
+  Car car_5;
+  Car car_6;
+  Car car_7;
+  std::unordered_map<int, Car> all_cars{};
+  std::vector<int> game_board{};
+};
+
+TEST_F(BoardTest, ConstructorMap) {
+  const Board board{all_cars};
+
+  ASSERT_EQ(board.getGameBoard(), game_board);
+  ASSERT_EQ(board.getCars(), all_cars);
+  ASSERT_EQ(board.getBoardSize(), 6);
+  ASSERT_EQ(board.getMainId(), 1);
+}
+
+TEST_F(BoardTest, ConstructorVector) {
+  const Board board{game_board};
+
+  ASSERT_EQ(board.getGameBoard(), game_board);
+  ASSERT_EQ(board.getCars(), all_cars);
+  ASSERT_EQ(board.getBoardSize(), 6);
+  ASSERT_EQ(board.getMainId(), 1);
+}
+
+TEST_F(BoardTest, EqualToOperator) {
+  Board board_1{game_board};
+  const Board board_2{all_cars};
+  Board board_3{{0, 0, 0, 0, 3, 3, 0, 0, 4, 0, 6, 0, 1, 1, 4, 0, 6, 0,
+                 5, 5, 4, 0, 0, 7, 0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+
+  ASSERT_TRUE(board_1 == board_2);
+  ASSERT_TRUE(board_2 == board_1);
+  ASSERT_FALSE(board_1 == board_3);
+  ASSERT_FALSE(board_3 == board_2);
+}
+
+TEST_F(BoardTest, TestSolvedMethod) {
+  // Normal board unsolved state
+  const Board board_1{game_board};
+
+  ASSERT_EQ(board_1.getMainId(), 1);
+  ASSERT_FALSE(board_1.solved());
+
+  // 1 car solved state
+  const Board board_2{{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1,
+                       0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+
+  ASSERT_EQ(board_2.getMainId(), 1);
+  ASSERT_TRUE(board_2.solved());
+
+  // 1 car with id 2 solved state
+  const Board board_3{{0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2,
+                       0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+                      2};
+
+  ASSERT_EQ(board_3.getMainId(), 2);
+  ASSERT_TRUE(board_3.solved());
+}
+
+TEST_F(BoardTest, TestGetGameBoardAtMethod) {
+  const Board board{game_board};
+
+  ASSERT_EQ(board.getGameBoardAt(0, 0), 0);
+  ASSERT_EQ(board.getGameBoardAt(3, 2), 4);
+  ASSERT_EQ(board.getGameBoardAt(5, 5), 7);
+  ASSERT_EQ(board.getGameBoardAt(4, 1), 2);
+  ASSERT_NE(board.getGameBoardAt(5, 1), 3);
+  ASSERT_NE(board.getGameBoardAt(1, 1), 6);
+  ASSERT_NE(board.getGameBoardAt(2, 1), 3);
+}
+
+TEST_F(BoardTest, TestSetGameBoardAtMethod) {
+  Board board{game_board};
+
+  ASSERT_EQ(board.getGameBoardAt(0, 0), 0);
+  board.setGameBoardAt(0, 0, 4);
+  ASSERT_EQ(board.getGameBoardAt(0, 0), 4);
+}
+
+TEST_F(BoardTest, TestGetMainCarMethod) {
+  Board board{game_board};
+
+  ASSERT_EQ(board.getMainId(), 1);
+  ASSERT_EQ(board.getMainCar().getId(), 1);
+  ASSERT_EQ(board.getMainCar(), Car(1, 2, 0, 2, Car::Direction::Horizontal));
+}
+
+TEST_F(BoardTest, TestGetPossibleStatesMethod) {
+  Board board{game_board};
+
+  auto states = board.getPossibleStates();
+  std::vector<std::string> output{};
+
+  // The order of states follows the order of cars in the unordered map, which
+  // differs between standard libraries
+  for (const auto &state : states) {
+    std::ostringstream oss{};
+    oss << state;
+    output.emplace_back(oss.str());
+  }
+  std::sort(output.begin(), output.end());
+
+  std::vector<std::string> expected{
+      "000333\n004000\n114060\n554067\n022207\n000007\n",
+      "000333\n004060\n114060\n554007\n002227\n000007\n",
+      "000333\n004060\n114060\n554007\n222007\n000007\n",
+      "000333\n004060\n114067\n554007\n022207\n000000\n",
+      "003330\n004060\n114060\n554007\n022207\n000007\n",
+      "004333\n004060\n114060\n550007\n022207\n000007\n"};
+  ASSERT_EQ(output, expected);
+}
+
+TEST_F(BoardTest, TestApplyMoveMethod) {
+  const Board board{game_board};
+
+  auto moved = board.applyMove(Move{4, 2});
+  ASSERT_EQ(moved.getCar(4), Car(4, 5, 2, 3, Car::Direction::Vertical));
+  ASSERT_EQ(moved.getGameBoardAt(2, 2), 0);
+  ASSERT_EQ(moved.getGameBoardAt(5, 2), 4);
+
+  ASSERT_EQ(board.getMoveTo(moved), Move(4, 2));
+  ASSERT_EQ(moved.getMoveTo(board), Move(4, -2));
+  ASSERT_EQ(board.getMoveTo(board), Move());
+}
+
+TEST_F(BoardTest, TestUpdateCarsAtBoardEdges) {
+  // Cars touching every edge of the board, including rows ending in a car
+  const Board board{{2, 2, 2, 0, 0, 3, 0, 0, 0, 0, 0, 3, 1, 1, 0, 0, 0, 3,
+                     4, 0, 0, 0, 5, 5, 4, 0, 0, 0, 0, 0, 4, 0, 6, 6, 6, 6}};
+
+  std::unordered_map<int, Car> cars{
+      {1, Car(1, 2, 0, 2, Car::Direction::Horizontal)},
+      {2, Car(2, 0, 0, 3, Car::Direction::Horizontal)},
+      {3, Car(3, 2, 5, 3, Car::Direction::Vertical)},
+      {4, Car(4, 5, 0, 3, Car::Direction::Vertical)},
+      {5, Car(5, 3, 4, 2, Car::Direction::Horizontal)},
+      {6, Car(6, 5, 2, 4, Car::Direction::Horizontal)}};
+
+  ASSERT_EQ(board.getCars(), cars);
+  ASSERT_EQ(Board{cars}.getGameBoard(), board.getGameBoard());
+}
+
+TEST_F(BoardTest, TestGetPossibleStatesPrunesTranspositions) {
+  const Board board = Board{game_board}.applyMove(Move{7, -1});
+  ASSERT_EQ(board.getLastMove(), Move(7, -1));
+  ASSERT_EQ(board.getPossibleStates().size(), 7u);
+
+  // The inverse of the last move and moves of lower IDs that do not touch
+  // the cells swept by car 7 are skipped
+  Board::GenerationOptions options{};
+  options.prune_transpositions = true;
+  auto states = board.getPossibleStates(options);
+  ASSERT_EQ(states.size(), 1u);
+  ASSERT_EQ(states[0].getLastMove(), Move(7, -1));
+  ASSERT_EQ(states[0].getCar(7), Car(7, 3, 5, 3, Car::Direction::Vertical));
+
+  // A search with pruning still reaches the goal
+  AStar::Options search_options{};
+  search_options.generation = options;
+  auto path = AStar::search(Board{game_board}, search_options);
+  ASSERT_FALSE(path.empty());
+  ASSERT_TRUE(path.back()->solved());
+}
+
+TEST_F(BoardTest, TestGetPossibleStatesSlides) {
+  const Board board{game_board};
+
+  Board::GenerationOptions options{};
+  options.slide = true;
+  auto states = board.getPossibleStates(options);
+  ASSERT_EQ(states.size(), 11u);
+
+  std::vector<Move> moves{};
+  for (const auto &s : states) {
+    moves.emplace_back(s.getLastMove());
+    ASSERT_EQ(board.getMoveTo(s), s.getLastMove());
+  }
+  ASSERT_NE(std::find(moves.begin(), moves.end(), Move(3, -3)), moves.end());
+  ASSERT_NE(std::find(moves.begin(), moves.end(), Move(6, 3)), moves.end());
+  ASSERT_EQ(std::find(moves.begin(), moves.end(), Move(7, -3)), moves.end());
+
+  // After a slide, the same car is not moved again
+  options.prune_transpositions = true;
+  const Board slid = board.applyMove(Move{7, -2});
+  for (const auto &s : slid.getPossibleStates(options)) {
+    ASSERT_NE(s.getLastMove().car_id, 7);
+  }
+
+  // Counting slides, a solution takes fewer moves than cells
+  AStar::Options search_options{};
+  search_options.generation = options;
+  search_options.cost = AStar::Options::Cost::Slides;
+  auto path = AStar::search(board, search_options);
+  ASSERT_FALSE(path.empty());
+  ASSERT_TRUE(path.back()->solved());
+  for (const auto &move : AStar::getMoves(path)) {
+    ASSERT_NE(move.delta, 0);
+  }
+}
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "../TrafficJamLogic/CompactBoard.h"
+#include "pch.h"
+
+class CompactBoardTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    cells = "oooCCCooDoFoAADoFoEEDooGoBBBoGoooooG";
+    board = Board{std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0,
+                                   1, 1, 4, 0, 6, 0, 5, 5, 4, 0, 0, 7,
+                                   0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+  }
+
+  std::string cells;
+  Board board;
+};
+
+TEST_F(CompactBoardTest, ParseMatchesBoard) {
+  auto compact = CompactBoard::parse(cells.data(), cells.size());
+  ASSERT_EQ(compact.getBoardSize(), 6);
+  ASSERT_EQ(compact.getMainId(), 1);
+  ASSERT_EQ(compact.getCarCount(), 7);
+  ASSERT_TRUE(compact.toBoard() == board);
+  ASSERT_TRUE(compact == CompactBoard{board});
+}
+
+TEST_F(CompactBoardTest, MatchesLayout) {
+  auto compact = CompactBoard::parse(cells.data(), cells.size());
+  const Layout layout{board};
+  ASSERT_EQ(compact.getLayoutKey(), layout.getKey());
+  ASSERT_EQ(compact.getState(), layout.encode(board));
+
+  // Moving a car keeps the layout and changes the state
+  auto moved = board;
+  moved.applyMove(Move{7, -1});
+  const CompactBoard compact_moved{moved};
+  ASSERT_EQ(compact_moved.getLayoutKey(), layout.getKey());
+  ASSERT_EQ(compact_moved.getState(), layout.encode(moved));
+}
+
+TEST_F(CompactBoardTest, RejectsInvalidCells) {
+  auto parse = [](const std::string &cells) {
+    return CompactBoard::parse(cells.data(), cells.size());
+  };
+  // Not square
+  ASSERT_THROW(parse("oooAAoo"), std::invalid_argument);
+  // Not a car letter
+  ASSERT_THROW(parse("oooooooooooooAAo1"), std::invalid_argument);
+  // A car that is not a straight line
+  ASSERT_THROW(parse("ooooAABooBoooooo"), std::invalid_argument);
+  ASSERT_THROW(parse("oooAooooAAoooooo"), std::invalid_argument);
+  // No main car
+  ASSERT_THROW(parse("ooooBBoooooooooo"), std::invalid_argument);
+  // Larger than a Layout
+  ASSERT_THROW(parse(std::string(81, 'o').replace(0, 2, "AA")),
+               std::invalid_argument);
+}
+
+TEST_F(CompactBoardTest, RejectsBoardsOutOfRange) {
+  // A car ID that does not fit in a byte
+  auto cells = board.getGameBoard();
+  std::replace(cells.begin(), cells.end(), 7, 300);
+  ASSERT_THROW(CompactBoard{Board{cells}}, std::invalid_argument);
+
+  // A vertical main car
+  std::unordered_map<int, Car> cars{{1, Car{1, 1, 0, 2, Car::Vertical}}};
+  ASSERT_THROW(CompactBoard(Board{cars, 6, 1}), std::invalid_argument);
+}
@@ -0,0 +1,91 @@
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "../TrafficJamLogic/CorpusReader.h"
+#include "pch.h"
+
+class CorpusReaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path = ::testing::TempDir() + "CorpusReaderTest.txt";
+    puzzles = {"oooCCCooDoFoAADoFoEEDooGoBBBoGoooooG",
+               "ooHHHoGGGEEooooAAFoIBBoFCIoooDCooooD",
+               "ooooooooooooAAoooooooooooooooooooooo",
+               "ooHHHoBoooooBAAoooBFFFGGCooEEoCIIDDD"};
+  }
+
+  void TearDown() override { std::remove(path.c_str()); }
+
+  void write(const std::string &contents) {
+    std::ofstream file{path, std::ios::binary};
+    file << contents;
+  }
+
+  std::string path;
+  std::vector<std::string> puzzles;
+};
+
+TEST_F(CorpusReaderTest, ReadsPuzzlesInOrder) {
+  std::string contents{};
+  for (auto i = 0; i < 50; ++i) {
+    const auto &cells = puzzles[i % puzzles.size()];
+    contents += cells + (i % 3 == 0 ? " 18\r\n" : "\n");
+    if (i % 7 == 0) {
+      contents += "\n";
+    }
+  }
+  write(contents);
+
+  // Chunks smaller than a line, parsed by several threads
+  CorpusReader::Options options{};
+  options.threads = 3;
+  options.chunk_bytes = 10;
+  auto boards = CorpusReader::read(path, options);
+  ASSERT_EQ(boards.size(), 50u);
+  for (std::size_t i = 0; i < boards.size(); ++i) {
+    const auto &cells = puzzles[i % puzzles.size()];
+    ASSERT_TRUE(boards[i] == CompactBoard::parse(cells.data(), cells.size()));
+  }
+  ASSERT_EQ(CorpusReader::read(path).size(), 50u);
+}
+
+TEST_F(CorpusReaderTest, ReportsLineOfInvalidPuzzle) {
+  write(puzzles[0] + "\n" + puzzles[1] + "\n\n" + "oooooAAB 3\n" +
+        puzzles[2] + "\n");
+
+  CorpusReader::Options options{};
+  options.chunk_bytes = 16;
+  try {
+    CorpusReader::read(path, options);
+    FAIL();
+  } catch (const std::invalid_argument &e) {
+    ASSERT_NE(std::string{e.what()}.find(path + ":4:"), std::string::npos);
+  }
+  ASSERT_THROW(CorpusReader::read(path + ".missing"), std::runtime_error);
+}
+
+TEST_F(CorpusReaderTest, ReportsLineOfVerticalMainCar) {
+  write(puzzles[0] + "\n" + "ooooooAoooooAooooooooooooooooooooooo\n" +
+        puzzles[1] + "\n");
+
+  try {
+    CorpusReader::read(path);
+    FAIL();
+  } catch (const std::invalid_argument &e) {
+    const std::string message{e.what()};
+    ASSERT_NE(message.find(path + ":2:"), std::string::npos);
+    ASSERT_NE(message.find("Main car is not horizontal"), std::string::npos);
+  }
+}
+
+TEST_F(CorpusReaderTest, LoadsBatchSolver) {
+  write(puzzles[0] + " 18\n" + puzzles[2] + " 4\n");
+
+  BatchSolver solver{};
+  ASSERT_EQ(CorpusReader::load(path, solver), 2u);
+  auto solutions = solver.solve();
+  ASSERT_EQ(solutions.size(), 2u);
+  ASSERT_EQ(solutions[0].size(), 19u);
+  ASSERT_EQ(solutions[1].size(), 5u);
+}
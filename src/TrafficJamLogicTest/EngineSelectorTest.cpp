@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include "../TrafficJamLogic/EngineSelector.h"
+#include "pch.h"
+
+class EngineSelectorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    board = Board{std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0,
+                                   1, 1, 4, 0, 6, 0, 5, 5, 4, 0, 0, 7,
+                                   0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+  }
+
+  EngineSelector parse(const std::string &rules) {
+    std::istringstream stream{rules};
+    return EngineSelector::parse(stream);
+  }
+
+  Board board;
+};
+
+TEST_F(EngineSelectorTest, GetFeatures) {
+  auto features = EngineSelector::getFeatures(board);
+  ASSERT_EQ(features.cars, 7);
+  ASSERT_EQ(features.blockers, 2);
+  ASSERT_EQ(features.free, 18);
+  ASSERT_EQ(features.congestion, 4);
+  ASSERT_EQ(features.h, AStar::calculateHValue(board));
+}
+
+TEST_F(EngineSelectorTest, SelectsFirstMatchingRule) {
+  auto selector = parse(
+      "# comment\n"
+      "cars>=10 -> astar\n"
+      "blockers==2 h<4 -> astar weight=2.5 prune lazy  # inline comment\n"
+      "\n"
+      "-> bitmap memory=64M\n");
+
+  auto selection = selector.select(board);
+  ASSERT_EQ(selection.engine, EngineSelector::Engine::AStar);
+  ASSERT_EQ(selection.rule, 3);
+  ASSERT_EQ(selection.options.weight, 2.5);
+  ASSERT_TRUE(selection.options.generation.prune_transpositions);
+  ASSERT_TRUE(selection.options.lazy_heuristic);
+
+  auto features = EngineSelector::getFeatures(board);
+  features.blockers = 1;
+  selection = selector.select(features);
+  ASSERT_EQ(selection.engine, EngineSelector::Engine::Bitmap);
+  ASSERT_EQ(selection.max_bytes, 64u << 20);
+
+  // Without rules every board goes to A*
+  ASSERT_EQ(EngineSelector{}.select(board).rule, 0);
+}
+
+TEST_F(EngineSelectorTest, RejectsMalformedRules) {
+  ASSERT_THROW(parse("cars>=10 astar"), std::invalid_argument);
+  ASSERT_THROW(parse("wheels>=10 -> astar"), std::invalid_argument);
+  ASSERT_THROW(parse("cars>=ten -> astar"), std::invalid_argument);
+  ASSERT_THROW(parse("-> idastar"), std::invalid_argument);
+  ASSERT_THROW(parse("-> astar weight=heavy"), std::invalid_argument);
+  ASSERT_THROW(parse("-> astar fast"), std::invalid_argument);
+}
+
+TEST_F(EngineSelectorTest, SolvesWithSelectedEngine) {
+  auto expected = AStar::search(board).size();
+  for (const auto *rules : {"-> astar", "-> bitmap", "-> bitmap memory=1K",
+                            "-> anytime", "-> store"}) {
+    auto path = parse(rules).solve(board);
+    ASSERT_EQ(path.size(), expected);
+    ASSERT_TRUE(path.back()->solved());
+  }
+}
+
+TEST_F(EngineSelectorTest, StoreEngineChecksStoredMoves) {
+  const auto path = ::testing::TempDir() + "EngineSelectorTest.tjss";
+  std::remove(path.c_str());
+  const auto expected = AStar::search(board);
+  const auto selector = parse("-> store");
+  {
+    SolutionStore store{path};
+    store.append(board, AStar::getMoves(expected));
+    ASSERT_EQ(selector.solve(board, &store).size(), expected.size());
+
+    // An illegal move and a move list that stops short are searched for
+    const Board next = board.applyMove(AStar::getMoves(expected)[0]);
+    store.append(next, {Move{1, 5}});
+    ASSERT_EQ(selector.solve(next, &store).size(), expected.size() - 1);
+    const Board second = next.applyMove(AStar::getMoves(expected)[1]);
+    store.append(second, {});
+    auto solved = selector.solve(second, &store);
+    ASSERT_EQ(solved.size(), expected.size() - 2);
+    ASSERT_TRUE(solved.back()->solved());
+  }
+  std::remove(path.c_str());
+}
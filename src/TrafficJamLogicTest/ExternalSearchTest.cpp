@@ -0,0 +1,82 @@
+#include <filesystem>
+#include <future>
+#include <set>
+#include "../TrafficJamLogic/ExternalSearch.h"
+#include "pch.h"
+
+class ExternalSearchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    board = Board{std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0,
+                                   1, 1, 4, 0, 6, 0, 5, 5, 4, 0, 0, 7,
+                                   0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+    options.directory = ::testing::TempDir();
+    // Small runs and buffers so every layer is split over many files
+    options.run_states = 64;
+    options.io_buffer_bytes = 256;
+  }
+
+  Board board;
+  ExternalSearch::Options options;
+};
+
+TEST_F(ExternalSearchTest, FindsShortestSolution) {
+  auto result = ExternalSearch::search(board, options);
+
+  ASSERT_EQ(result.path.size(), 19u);
+  ASSERT_EQ(result.layer_sizes.size(), 19u);
+  ASSERT_TRUE(*result.path.front() == board);
+  ASSERT_TRUE(result.path.back()->solved());
+  for (std::size_t i = 1; i < result.path.size(); ++i) {
+    ASSERT_EQ(std::abs(result.path[i - 1]->getMoveTo(*result.path[i]).delta),
+              1);
+  }
+}
+
+TEST_F(ExternalSearchTest, EnumeratesUnsolvableStateSpace) {
+  // The main car is blocked by a car in its own row
+  const Board blocked{{0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 3, 1, 1, 0, 2, 2, 2,
+                       0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0}};
+  auto result = ExternalSearch::search(blocked, options);
+
+  // Count the reachable states with an in-memory breadth-first search
+  const Layout layout{blocked};
+  std::set<std::uint64_t> visited{layout.encode(blocked)};
+  std::vector<std::uint64_t> frontier{layout.encode(blocked)};
+  std::vector<std::uint64_t> expected_sizes{1};
+  while (!frontier.empty()) {
+    std::vector<std::uint64_t> successors{};
+    std::vector<std::uint64_t> next{};
+    for (const auto &state : frontier) {
+      layout.getSuccessors(state, successors);
+    }
+    for (const auto &s : successors) {
+      if (visited.insert(s).second) {
+        next.emplace_back(s);
+      }
+    }
+    if (!next.empty()) {
+      expected_sizes.emplace_back(next.size());
+    }
+    frontier.swap(next);
+  }
+
+  ASSERT_TRUE(result.path.empty());
+  ASSERT_EQ(result.layer_sizes, expected_sizes);
+}
+
+TEST_F(ExternalSearchTest, ConcurrentSearchesKeepTheirFiles) {
+  options.directory = ::testing::TempDir() + "ExternalSearchTest";
+  std::filesystem::create_directory(options.directory);
+
+  auto first = std::async(std::launch::async, [&] {
+    return ExternalSearch::search(board, options);
+  });
+  auto second = ExternalSearch::search(board, options);
+  ASSERT_EQ(first.get().path.size(), 19u);
+  ASSERT_EQ(second.path.size(), 19u);
+
+  // Every search removes its files
+  ASSERT_TRUE(std::filesystem::is_empty(options.directory));
+  std::filesystem::remove(options.directory);
+}
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include "../TrafficJamLogic/Layout.h"
+#include "pch.h"
+
+class LayoutTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    board = Board{std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0,
+                                   1, 1, 4, 0, 6, 0, 5, 5, 4, 0, 0, 7,
+                                   0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+    layout = Layout{board};
+  }
+
+  Board board;
+  Layout layout;
+};
+
+TEST_F(LayoutTest, OrdersCarsByLane) {
+  ASSERT_EQ(layout.getCarCount(), 7);
+  ASSERT_EQ(layout.getBoardSize(), 6);
+  ASSERT_EQ(layout.getMainId(), 1);
+  ASSERT_EQ(layout.getId(0), 3);
+  ASSERT_EQ(layout.getId(layout.getMainIndex()), 1);
+  ASSERT_EQ(layout.getLane(layout.getIndex(7)), 5);
+  ASSERT_EQ(layout.getDirection(layout.getIndex(4)), Car::Direction::Vertical);
+  ASSERT_EQ(layout.getIndex(9), -1);
+}
+
+TEST_F(LayoutTest, EncodeAndDecode) {
+  auto state = layout.encode(board);
+
+  ASSERT_EQ(Layout::getPosition(state, layout.getIndex(3)), 3);
+  ASSERT_EQ(Layout::getPosition(state, layout.getIndex(4)), 1);
+  ASSERT_TRUE(layout.decode(state) == board);
+  ASSERT_EQ(layout.decode(state).getCars(), board.getCars());
+  ASSERT_FALSE(layout.solved(state));
+  // One bit per occupied cell, bit 0 is the top-left cell
+  ASSERT_EQ(layout.getOccupancy(state), 0x82e9d7538u);
+}
+
+TEST_F(LayoutTest, SuccessorsMatchBoardStates) {
+  std::vector<std::uint64_t> successors{};
+  layout.getSuccessors(layout.encode(board), successors);
+
+  std::vector<std::uint64_t> expected{};
+  for (const auto &state : board.getPossibleStates()) {
+    expected.emplace_back(layout.encode(state));
+  }
+
+  std::sort(successors.begin(), successors.end());
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQ(successors, expected);
+}
+
+TEST_F(LayoutTest, BatchSuccessorsMatchSuccessors) {
+  // A few layers of states, more than a batch of four and not a multiple of
+  // it
+  std::vector<std::uint64_t> states{layout.encode(board)};
+  for (std::size_t i = 0; states.size() < 103; ++i) {
+    layout.getSuccessors(states[i], states);
+  }
+  states.resize(103);
+
+  std::vector<std::uint64_t> expected{};
+  for (const auto &state : states) {
+    layout.getSuccessors(state, expected);
+  }
+  std::vector<std::uint64_t> successors{};
+  layout.getSuccessors(states.data(), states.size(), successors);
+  ASSERT_EQ(successors, expected);
+
+  // Vertical cars on an 8x8 board reach the last row
+  const Board large{std::vector<int>{
+      2, 0, 0, 0, 0, 0, 0, 3,
+      2, 0, 0, 0, 0, 0, 0, 3,
+      0, 0, 0, 0, 0, 0, 0, 3,
+      1, 1, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0,
+      4, 4, 4, 4, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 5,
+      0, 0, 0, 0, 0, 0, 0, 5}};
+  const Layout large_layout{large};
+  states.assign({large_layout.encode(large)});
+  for (std::size_t i = 0; states.size() < 50; ++i) {
+    large_layout.getSuccessors(states[i], states);
+  }
+  expected.clear();
+  for (const auto &state : states) {
+    large_layout.getSuccessors(state, expected);
+  }
+  successors.clear();
+  large_layout.getSuccessors(states.data(), states.size(), successors);
+  ASSERT_EQ(successors, expected);
+}
+
+TEST_F(LayoutTest, RejectsLargeBoards) {
+  ASSERT_THROW(Layout{Board{std::vector<int>(81)}}, std::invalid_argument);
+}
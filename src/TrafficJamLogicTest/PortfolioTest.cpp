@@ -0,0 +1,67 @@
+#include <stdexcept>
+#include <thread>
+#include "../TrafficJamLogic/Portfolio.h"
+#include "pch.h"
+
+class PortfolioTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // A puzzle with an optimal solution of 29 one-cell moves
+    board = Board{std::vector<int>{3, 0, 4, 0, 8,  8,  3, 0, 4, 0, 12, 10,
+                                   1, 1, 4, 5, 12, 10, 6, 6, 6, 5, 0,  10,
+                                   7, 0, 0, 9, 9,  0,  7, 2, 2, 0, 11, 11}};
+  }
+
+  Board board;
+};
+
+TEST_F(PortfolioTest, ReturnsFirstEngineAndCancelsOthers) {
+  // An engine that only stops when it is cancelled
+  Portfolio::Engine stuck{
+      "stuck",
+      [](const Board &, const AStar::CancellationToken &cancellation)
+          -> std::vector<std::shared_ptr<Board>> {
+        while (!cancellation.isCancelled()) {
+          std::this_thread::yield();
+        }
+        throw AStar::SearchCancelled{};
+      },
+      1.0};
+
+  auto result = Portfolio::solve(board, {stuck, Portfolio::aStar("astar")});
+  ASSERT_EQ(result.engine, "astar");
+  ASSERT_EQ(result.path.size(), 30u);
+  ASSERT_EQ(result.bound, 1.0);
+}
+
+TEST_F(PortfolioTest, SkipsEnginesAboveBound) {
+  auto engines = Portfolio::getDefaultEngines();
+  auto result = Portfolio::solve(board, engines, 1.0);
+  ASSERT_EQ(result.engine, "astar");
+  ASSERT_EQ(result.path.size(), 30u);
+
+  result = Portfolio::solve(board, engines);
+  ASSERT_TRUE(result.path.back()->solved());
+  ASSERT_LE(result.path.size() - 1, 29 * result.bound);
+
+  ASSERT_THROW(Portfolio::solve(board, engines, 0.5), std::invalid_argument);
+
+  // Pruning engines claim no bound
+  AStar::Options pruned{};
+  pruned.generation.prune_transpositions = true;
+  ASSERT_GT(Portfolio::aStar("pruned", pruned).bound, 5.0);
+  ASSERT_EQ(engines.back().bound, 1.0);
+}
+
+TEST_F(PortfolioTest, RethrowsWhenEveryEngineFails) {
+  Portfolio::Engine failing{
+      "failing",
+      [](const Board &, const AStar::CancellationToken &)
+          -> std::vector<std::shared_ptr<Board>> {
+        throw std::runtime_error("failed");
+      },
+      1.0};
+
+  ASSERT_THROW(Portfolio::solve(board, {failing, failing}),
+               std::runtime_error);
+}
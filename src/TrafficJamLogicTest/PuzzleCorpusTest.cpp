@@ -0,0 +1,176 @@
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../TrafficJamLogic/CorpusReader.h"
+#include "../TrafficJamLogic/PuzzleCorpus.h"
+#include "pch.h"
+
+class PuzzleCorpusTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path = ::testing::TempDir() + "PuzzleCorpusTest.tjpc";
+    text_path = ::testing::TempDir() + "PuzzleCorpusTest.txt";
+    board = Board{std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0,
+                                   1, 1, 4, 0, 6, 0, 5, 5, 4, 0, 0, 7,
+                                   0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+  }
+
+  void TearDown() override {
+    std::remove(path.c_str());
+    std::remove(text_path.c_str());
+  }
+
+  void writeText(const std::string &contents) {
+    std::ofstream file{text_path, std::ios::binary};
+    file << contents;
+  }
+
+  std::string path;
+  std::string text_path;
+  Board board;
+};
+
+TEST_F(PuzzleCorpusTest, RoundTripsBoards) {
+  auto moved = board;
+  moved.applyMove(Move{7, -2});
+  {
+    PuzzleCorpusWriter writer{path, 6};
+    writer.write(board);
+    writer.write(CompactBoard{moved});
+    writer.close();
+  }
+
+  const PuzzleCorpus corpus{path};
+  ASSERT_EQ(corpus.size(), 2u);
+  ASSERT_EQ(corpus.getBoardSize(), 6);
+  ASSERT_EQ(corpus.getMainId(), 1);
+
+  auto it = corpus.begin();
+  ASSERT_EQ(it->getCarCount(), 7);
+  ASSERT_EQ(it->getSize(), 15u);
+  ASSERT_TRUE(it->toBoard() == board);
+  ++it;
+  ASSERT_TRUE(it->toCompactBoard() == CompactBoard{moved});
+  ASSERT_TRUE(++it == corpus.end());
+
+  // CorpusReader reads packed corpora as well as text
+  auto boards = CorpusReader::read(path);
+  ASSERT_EQ(boards.size(), 2u);
+  ASSERT_TRUE(boards[1].toBoard() == moved);
+}
+
+TEST_F(PuzzleCorpusTest, RejectsInvalidInput) {
+  PuzzleCorpusWriter writer{path, 6};
+  const Board small{std::vector<int>{0, 0, 0, 0, 1, 1, 0, 0, 0}};
+  ASSERT_THROW(writer.write(small), std::invalid_argument);
+  writer.close();
+
+  // A record whose cars run past the end of the file
+  std::FILE *file = std::fopen(path.c_str(), "ab");
+  std::fputc(3, file);
+  std::fputc(0, file);
+  std::fclose(file);
+  ASSERT_THROW(PuzzleCorpus{path}, std::runtime_error);
+
+  writeText("not a corpus");
+  ASSERT_THROW(PuzzleCorpus{text_path}, std::runtime_error);
+
+  // Invalid arguments leave an existing file alone
+  ASSERT_THROW(PuzzleCorpusWriter(text_path, 9), std::invalid_argument);
+  ASSERT_THROW(PuzzleCorpus{text_path}, std::runtime_error);
+  std::ifstream text{text_path};
+  std::string contents{};
+  std::getline(text, contents);
+  ASSERT_EQ(contents, "not a corpus");
+}
+
+TEST_F(PuzzleCorpusTest, RejectsCorruptRecords) {
+  // A car is 2 bytes: cell, direction << 6, (length - 1) << 7, id << 10
+  auto car = [](int cell, int direction, int length, int id) {
+    const int packed = cell | direction << 6 | (length - 1) << 7 | id << 10;
+    return std::string{static_cast<char>(packed & 0xff),
+                       static_cast<char>(packed >> 8)};
+  };
+  const std::string main = car(12, Car::Horizontal, 2, 1);
+  const std::vector<std::string> records{
+      // A vertical car from row 5 of 6 down past the edge
+      std::string(1, 2) + main + car(33, Car::Vertical, 3, 2),
+      // A horizontal car on row 10
+      std::string(1, 2) + main + car(60, Car::Horizontal, 2, 2),
+      // Overlapping cars
+      std::string(1, 2) + main + car(13, Car::Horizontal, 2, 2),
+      // Two cars with the same ID
+      std::string(1, 2) + main + car(0, Car::Horizontal, 2, 1),
+      // No main car
+      std::string(1, 1) + car(0, Car::Horizontal, 2, 2),
+      // A vertical main car
+      std::string(1, 1) + car(0, Car::Vertical, 2, 1)};
+
+  for (const auto &record : records) {
+    {
+      PuzzleCorpusWriter writer{path, 6};
+      writer.write(board);
+      writer.close();
+    }
+    std::FILE *file = std::fopen(path.c_str(), "ab");
+    std::fwrite(record.data(), 1, record.size(), file);
+    std::fclose(file);
+
+    try {
+      PuzzleCorpus corpus{path};
+      FAIL() << "Corrupt record was accepted";
+    } catch (const std::runtime_error &e) {
+      ASSERT_NE(std::string{e.what()}.find("record 1"), std::string::npos);
+    }
+  }
+
+  // More cars than a Layout holds
+  std::string crowded(1, 17);
+  crowded += main;
+  for (auto id = 2; id <= 17; ++id) {
+    crowded += car(id + 16, Car::Vertical, 2, id);
+  }
+  {
+    PuzzleCorpusWriter writer{path, 8};
+    writer.close();
+  }
+  std::FILE *file = std::fopen(path.c_str(), "ab");
+  std::fwrite(crowded.data(), 1, crowded.size(), file);
+  std::fclose(file);
+  ASSERT_THROW(PuzzleCorpus{path}, std::runtime_error);
+}
+
+TEST_F(PuzzleCorpusTest, ConvertsLines) {
+  writeText(
+      "oooCCCooDoFoAADoFoEEDooGoBBBoGoooooG 18\n"
+      "ooHHHoGGGEEooooAAFoIBBoFCIoooDCooooD 3\n");
+  ASSERT_EQ(PuzzleCorpus::convertLines(text_path, path), 2u);
+
+  const PuzzleCorpus corpus{path};
+  ASSERT_EQ(corpus.size(), 2u);
+  ASSERT_TRUE(corpus.begin()->toBoard() == board);
+}
+
+TEST_F(PuzzleCorpusTest, ConvertsGrids) {
+  // Boards printed as in the README
+  writeText(
+      "000333\n004060\n114060\n554007\n022207\n000007\n"
+      "\n"
+      "033300\r\n004060\r\n114060\r\n554007\r\n022207\r\n000007\r\n");
+  ASSERT_EQ(PuzzleCorpus::convertGrids(text_path, path), 2u);
+
+  const PuzzleCorpus corpus{path};
+  ASSERT_EQ(corpus.size(), 2u);
+  ASSERT_TRUE(corpus.begin()->toBoard() == board);
+
+  writeText("0000\n1100\n0000\n0000\n\n114060\n55\n");
+  try {
+    PuzzleCorpus::convertGrids(text_path, path);
+    FAIL();
+  } catch (const std::invalid_argument &e) {
+    ASSERT_NE(std::string{e.what()}.find(text_path + ":6:"),
+              std::string::npos);
+  }
+}
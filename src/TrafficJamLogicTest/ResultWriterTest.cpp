@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include "../TrafficJamLogic/ResultWriter.h"
+#include "pch.h"
+
+class ResultWriterTest : public ::testing::Test {
+ protected:
+  void SetUp() override { file = std::tmpfile(); }
+
+  void TearDown() override { std::fclose(file); }
+
+  /// <summary>
+  /// Write the fixture's records and read back the whole output.
+  /// </summary>
+  std::string writeAll(ResultWriter::Format format,
+                       std::size_t buffer_bytes = 1024) {
+    {
+      ResultWriter writer{file, format, buffer_bytes};
+      writer.write(0, std::vector<Move>{{4, 1}, {7, -2}});
+      writer.write(1, std::vector<std::shared_ptr<Board>>{});
+      writer.write(2, std::vector<Move>{});
+    }
+
+    std::string output{};
+    std::rewind(file);
+    for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+      output.push_back(static_cast<char>(c));
+    }
+    return output;
+  }
+
+  std::FILE *file;
+};
+
+TEST_F(ResultWriterTest, WritesText) {
+  ASSERT_EQ(writeAll(ResultWriter::Format::Text),
+            "0: 4+1 7-2\n1: unsolvable\n2:\n");
+}
+
+TEST_F(ResultWriterTest, WritesJson) {
+  ASSERT_EQ(writeAll(ResultWriter::Format::Json),
+            "[\n{\"id\":0,\"moves\":[[4,1],[7,-2]]},\n"
+            "{\"id\":1,\"moves\":null},\n{\"id\":2,\"moves\":[]}]\n");
+}
+
+TEST_F(ResultWriterTest, WritesBinary) {
+  // A buffer smaller than a record flushes after every record
+  const std::string expected{
+      "TJRB\x01"
+      "\x00\x00\x00\x00\x02\x00\x41\x7e"
+      "\x01\x00\x00\x00\xff\xff"
+      "\x02\x00\x00\x00\x00\x00",
+      25};
+  ASSERT_EQ(writeAll(ResultWriter::Format::Binary, 1), expected);
+
+  ResultWriter writer{file, ResultWriter::Format::Binary};
+  ASSERT_THROW(writer.write(3, std::vector<Move>{{16, 1}}),
+               std::invalid_argument);
+  ASSERT_THROW(writer.write(3, std::vector<Move>{{1, 8}}),
+               std::invalid_argument);
+}
+
+TEST_F(ResultWriterTest, WritesSolutionPath) {
+  Board board{std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0,
+                               1, 1, 4, 0, 6, 0, 5, 5, 4, 0, 0, 7,
+                               0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+  auto path = AStar::search(board);
+
+  std::string line{"7:"};
+  for (const auto &move : AStar::getMoves(path)) {
+    line += ' ' + std::to_string(move.car_id) + (move.delta > 0 ? "+" : "") +
+            std::to_string(move.delta);
+  }
+  line += '\n';
+  const std::string expected = line + line;
+
+  AStar::Workspace workspace{};
+  {
+    ResultWriter writer{file, ResultWriter::Format::Text};
+    writer.write(7, path);
+    writer.write(7, AStar::searchRange(board, {}, workspace));
+  }
+  std::string output(expected.size() + 1, '\0');
+  std::rewind(file);
+  output.resize(std::fread(&output[0], 1, output.size(), file));
+  ASSERT_EQ(output, expected);
+}
@@ -0,0 +1,127 @@
+#include <cstdio>
+#include "../TrafficJamLogic/SolutionStore.h"
+#include "../TrafficJamLogic/Symmetry.h"
+#include "pch.h"
+
+class SolutionStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path = ::testing::TempDir() + "SolutionStoreTest.tjss";
+    std::remove(path.c_str());
+
+    board = Board{std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0,
+                                   1, 1, 4, 0, 6, 0, 5, 5, 4, 0, 0, 7,
+                                   0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+    moves = {{3, -1}, {6, 1}, {1, 1}};
+  }
+
+  void TearDown() override { std::remove(path.c_str()); }
+
+  std::string path;
+  Board board;
+  std::vector<Move> moves;
+};
+
+TEST_F(SolutionStoreTest, AppendAndFind) {
+  SolutionStore store{path};
+  SolutionStore::Solution solution{};
+
+  ASSERT_EQ(store.size(), 0);
+  ASSERT_FALSE(store.find(board, solution));
+
+  ASSERT_TRUE(store.append(board, moves));
+  ASSERT_FALSE(store.append(board, moves));
+  ASSERT_EQ(store.size(), 1);
+
+  ASSERT_TRUE(store.find(board, solution));
+  ASSERT_EQ(solution.getMoves(), moves);
+}
+
+TEST_F(SolutionStoreTest, ReopenMapsStoredSolutions) {
+  {
+    SolutionStore store{path};
+    store.append(board, moves);
+    store.append(board.applyMove(moves[0]), {moves[1], moves[2]});
+  }
+
+  SolutionStore store{path};
+  SolutionStore::Solution solution{};
+
+  ASSERT_EQ(store.size(), 2);
+  ASSERT_TRUE(store.find(board, solution));
+  ASSERT_EQ(solution.size(), 3);
+  ASSERT_EQ(solution[1], Move(6, 1));
+  ASSERT_TRUE(store.find(board.applyMove(moves[0]), solution));
+  ASSERT_EQ(solution.getMoves(), std::vector<Move>({moves[1], moves[2]}));
+}
+
+TEST_F(SolutionStoreTest, RejectsOtherFiles) {
+  std::FILE *file = std::fopen(path.c_str(), "wb");
+  std::fputs("not a store", file);
+  std::fclose(file);
+
+  ASSERT_THROW(SolutionStore{path}, std::runtime_error);
+}
+
+TEST_F(SolutionStoreTest, ReopenCutsTruncatedRecord) {
+  {
+    SolutionStore store{path};
+    store.append(board, moves);
+  }
+  // A record header promising more bytes than the file holds
+  std::FILE *file = std::fopen(path.c_str(), "ab");
+  std::fputs("\x26\x05", file);
+  std::fputc(0, file);
+  std::fclose(file);
+
+  const Board next = board.applyMove(moves[0]);
+  {
+    SolutionStore store{path};
+    ASSERT_EQ(store.size(), 1);
+    ASSERT_TRUE(store.append(next, {moves[1], moves[2]}));
+  }
+
+  SolutionStore store{path};
+  SolutionStore::Solution solution{};
+  ASSERT_EQ(store.size(), 2);
+  ASSERT_TRUE(store.find(board, solution));
+  ASSERT_EQ(solution.getMoves(), moves);
+  ASSERT_TRUE(store.find(next, solution));
+  ASSERT_EQ(solution.getMoves(), std::vector<Move>({moves[1], moves[2]}));
+}
+
+TEST_F(SolutionStoreTest, CompactSortsRecords) {
+  // Every board along the solution, appended from the last one
+  std::vector<Board> boards{board};
+  for (const auto &move : moves) {
+    boards.emplace_back(boards.back().applyMove(move));
+  }
+  {
+    SolutionStore store{path};
+    for (std::size_t i = boards.size() - 1; i-- > 0;) {
+      store.append(boards[i],
+                   std::vector<Move>(moves.begin() + i, moves.end()));
+    }
+    store.compact();
+    ASSERT_EQ(store.size(), 3);
+    ASSERT_FALSE(store.append(boards[1], {}));
+
+    // Records appended after compacting go to the log
+    ASSERT_TRUE(store.append(boards[3], {}));
+  }
+
+  SolutionStore store{path};
+  SolutionStore::Solution solution{};
+  ASSERT_EQ(store.size(), 4);
+  for (std::size_t i = 0; i < boards.size(); ++i) {
+    ASSERT_TRUE(store.find(boards[i], solution));
+    ASSERT_EQ(solution.getMoves(),
+              std::vector<Move>(moves.begin() + i, moves.end()));
+  }
+  ASSERT_FALSE(store.find(Symmetry::mirror(board), solution));
+
+  store.compact();
+  ASSERT_EQ(store.size(), 4);
+  ASSERT_TRUE(store.find(boards[2], solution));
+  ASSERT_EQ(solution.getMoves(), std::vector<Move>({moves[2]}));
+}
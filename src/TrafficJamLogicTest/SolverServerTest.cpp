@@ -0,0 +1,69 @@
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include "../TrafficJamLogic/SolverServer.h"
+#include "pch.h"
+
+class SolverServerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path = ::testing::TempDir() + "solver-" + std::to_string(::getpid()) +
+           ".sock";
+    SolverServer::Options options{};
+    options.path = path;
+    options.workers = 2;
+    server = std::make_unique<SolverServer>(options);
+    thread = std::thread{[this] { server->run(); }};
+
+    // A puzzle with an optimal solution of 7 one-cell moves
+    board = Board{std::vector<int>{5,  5,  0, 2, 2, 2, 9,  9,  4, 4, 4, 0,
+                                   1,  1,  0, 0, 0, 6, 12, 10, 3, 3, 3, 6,
+                                   12, 10, 0, 8, 8, 11, 7, 7, 7, 0, 0, 11}};
+  }
+
+  void TearDown() override {
+    server->stop();
+    thread.join();
+    server.reset();
+  }
+
+  std::string path;
+  std::unique_ptr<SolverServer> server;
+  std::thread thread;
+  Board board;
+};
+
+TEST_F(SolverServerTest, SolvesPipelinedRequests) {
+  SolverClient client{path};
+  const Board other{std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0,
+                                     1, 1, 4, 0, 6, 0, 5, 5, 4, 0, 0, 7,
+                                     0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+
+  // Send every request before reading any response
+  for (std::uint32_t id = 0; id < 8; ++id) {
+    client.send(id, id % 2 == 0 ? board : other);
+  }
+
+  std::vector<bool> answered(8, false);
+  for (auto i = 0; i < 8; ++i) {
+    auto response = client.receive();
+    ASSERT_LT(response.id, 8u);
+    ASSERT_FALSE(answered[response.id]);
+    answered[response.id] = true;
+
+    ASSERT_EQ(response.status, SolverServer::Status::Solved);
+    const Board &start = response.id % 2 == 0 ? board : other;
+    ASSERT_EQ(response.moves, AStar::getMoves(AStar::search(start)));
+  }
+}
+
+TEST_F(SolverServerTest, RejectsInvalidBoards) {
+  SolverClient client{path};
+
+  // A board without the main car
+  client.send(7, Board{std::vector<int>(36, 0)});
+  auto response = client.receive();
+  ASSERT_EQ(response.id, 7u);
+  ASSERT_EQ(response.status, SolverServer::Status::Invalid);
+  ASSERT_TRUE(response.moves.empty());
+}
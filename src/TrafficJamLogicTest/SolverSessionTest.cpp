@@ -0,0 +1,69 @@
+#include "../TrafficJamLogic/SolverSession.h"
+#include "pch.h"
+
+class SolverSessionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // A puzzle with an optimal solution of 7 one-cell moves
+    board = Board{std::vector<int>{5,  5,  0, 2, 2, 2, 9,  9,  4, 4, 4, 0,
+                                   1,  1,  0, 0, 0, 6, 12, 10, 3, 3, 3, 6,
+                                   12, 10, 0, 8, 8, 11, 7, 7, 7, 0, 0, 11}};
+  }
+
+  Board board;
+};
+
+TEST_F(SolverSessionTest, FollowsSolutionWithoutSearching) {
+  SolverSession session{board};
+  ASSERT_EQ(session.getSolution().size(), 8u);
+  ASSERT_EQ(session.getSearchCount(), 1u);
+
+  for (auto remaining = 7u; remaining > 0; --remaining) {
+    auto &solution = session.applyMove(session.getHint());
+    ASSERT_EQ(solution.size(), remaining);
+  }
+  ASSERT_TRUE(session.getBoard().solved());
+  ASSERT_EQ(session.getHint(), Move());
+  ASSERT_EQ(session.getSearchCount(), 1u);
+}
+
+TEST_F(SolverSessionTest, RepairsSolutionAfterDeviation) {
+  SolverSession session{board};
+
+  // Moving a car off the solution and back costs one search, which stops at
+  // the known board
+  auto hint = session.getHint();
+  Move away{0, 0};
+  Board::GenerationOptions options{};
+  for (const auto &s : board.getPossibleStates(options)) {
+    if (s.getLastMove().car_id != hint.car_id) {
+      away = s.getLastMove();
+      break;
+    }
+  }
+  ASSERT_NE(away, Move());
+
+  auto &solution = session.applyMove(away);
+  ASSERT_EQ(session.getSearchCount(), 2u);
+  ASSERT_EQ(solution.size(), AStar::search(session.getBoard()).size());
+  ASSERT_TRUE(solution.back()->solved());
+
+  ASSERT_THROW(session.applyMove(Move{1, 5}), std::invalid_argument);
+}
+
+TEST_F(SolverSessionTest, PrunedSearchAfterMoveStaysShortest) {
+  AStar::Options options{};
+  options.generation.prune_transpositions = true;
+  SolverSession session{board, options};
+
+  // A move off the solution, its shortest repair may undo it
+  for (const auto &s : board.getPossibleStates()) {
+    if (s.getLastMove() != session.getHint()) {
+      session.applyMove(s.getLastMove());
+      break;
+    }
+  }
+  ASSERT_EQ(session.getBoard().getLastMove(), Move());
+  ASSERT_EQ(session.getSolution().size(),
+            AStar::search(session.getBoard()).size());
+}
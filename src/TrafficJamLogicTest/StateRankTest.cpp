@@ -0,0 +1,66 @@
+#include "../TrafficJamLogic/AStar.h"
+#include "../TrafficJamLogic/BitmapSearch.h"
+#include "../TrafficJamLogic/StateRank.h"
+#include "pch.h"
+
+class StateRankTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    board = Board{std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0,
+                                   1, 1, 4, 0, 6, 0, 5, 5, 4, 0, 0, 7,
+                                   0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7}};
+    layout = Layout{board};
+  }
+
+  Board board;
+  Layout layout;
+};
+
+TEST_F(StateRankTest, RankAndUnrankAreInverse) {
+  const StateRank ranking{layout};
+
+  // Lanes: row 0 (4 placements), row 2 (5), row 3 (5), row 4 (4), and
+  // columns 2, 4, 5 (4, 5 and 4 placements)
+  ASSERT_EQ(ranking.getSize(), 4u * 5 * 5 * 4 * 4 * 5 * 4);
+
+  for (std::uint64_t r = 0; r < ranking.getSize(); ++r) {
+    ASSERT_EQ(ranking.rank(ranking.unrank(r)), r);
+  }
+  auto state = layout.encode(board);
+  ASSERT_EQ(ranking.unrank(ranking.rank(state)), state);
+}
+
+TEST_F(StateRankTest, RanksSharedLanes) {
+  // Two cars in row 0 and two cars in column 5
+  const Board shared{{2, 2, 0, 3, 3, 0, 0, 0, 0, 0, 0, 4, 1, 1, 0, 0, 0, 4,
+                      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 5}};
+  const Layout shared_layout{shared};
+  const StateRank ranking{shared_layout};
+
+  // C(2 + 2, 2) placements for each shared lane and 5 for the main car
+  ASSERT_EQ(ranking.getSize(), 6u * 5 * 6);
+
+  std::vector<bool> seen(ranking.getSize());
+  for (std::uint64_t r = 0; r < ranking.getSize(); ++r) {
+    auto state = ranking.unrank(r);
+    auto row_cars = shared_layout.getCarMask(0, Layout::getPosition(state, 0)) &
+                    shared_layout.getCarMask(1, Layout::getPosition(state, 1));
+    ASSERT_EQ(row_cars, 0u);
+    ASSERT_LT(Layout::getPosition(state, 0), Layout::getPosition(state, 1));
+    ASSERT_FALSE(seen[ranking.rank(state)]);
+    seen[ranking.rank(state)] = true;
+  }
+}
+
+TEST_F(StateRankTest, BitmapSearchFindsShortestSolution) {
+  auto path = BitmapSearch::search(board);
+
+  ASSERT_EQ(path.size(), 19u);
+  ASSERT_TRUE(*path.front() == board);
+  ASSERT_TRUE(path.back()->solved());
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    ASSERT_EQ(std::abs(path[i - 1]->getMoveTo(*path[i]).delta), 1);
+  }
+
+  ASSERT_THROW(BitmapSearch::search(board, 1024), std::length_error);
+}
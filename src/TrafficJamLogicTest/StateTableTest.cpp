@@ -0,0 +1,47 @@
+#include "../TrafficJamLogic/StateTable.h"
+#include "pch.h"
+
+class StateTableTest : public ::testing::Test {
+ protected:
+  StateTable table{4};
+};
+
+TEST_F(StateTableTest, InsertAndFind) {
+  ASSERT_EQ(table.find(42), StateTable::kNone);
+
+  auto inserted = table.insert(42);
+  ASSERT_EQ(inserted.first, 0u);
+  ASSERT_TRUE(inserted.second);
+  ASSERT_EQ(table.insert(7).first, 1u);
+
+  inserted = table.insert(42);
+  ASSERT_EQ(inserted.first, 0u);
+  ASSERT_FALSE(inserted.second);
+  ASSERT_EQ(table.find(7), 1u);
+  ASSERT_EQ(table.size(), 2u);
+
+  // Key 0 is a valid state
+  ASSERT_EQ(table.find(0), StateTable::kNone);
+  ASSERT_EQ(table.insert(0).first, 2u);
+  ASSERT_EQ(table.find(0), 2u);
+}
+
+TEST_F(StateTableTest, KeepsValuesWhenGrowing) {
+  for (std::uint64_t key = 0; key < 1000; ++key) {
+    table.prefetch(key << 4);
+    auto index = table.insert(key << 4).first;
+    table.setGValue(index, static_cast<int>(key));
+    table.setParent(index, index == 0 ? StateTable::kNone : index - 1);
+  }
+
+  ASSERT_EQ(table.size(), 1000u);
+  for (std::uint64_t key = 0; key < 1000; ++key) {
+    auto index = table.find(key << 4);
+    ASSERT_EQ(index, key);
+    ASSERT_EQ(table.getKey(index), key << 4);
+    ASSERT_EQ(table.getGValue(index), static_cast<int>(key));
+  }
+  ASSERT_EQ(table.getParent(0), StateTable::kNone);
+  ASSERT_EQ(table.getParent(999), 998u);
+  ASSERT_EQ(table.find(1), StateTable::kNone);
+}
@@ -0,0 +1,68 @@
+#include "../TrafficJamLogic/Symmetry.h"
+#include "pch.h"
+
+class SymmetryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    game_board =
+        std::vector<int>{0, 0, 0, 3, 3, 3, 0, 0, 4, 0, 6, 0, 1, 1, 4, 0, 6, 0,
+                         5, 5, 4, 0, 0, 7, 0, 2, 2, 2, 0, 7, 0, 0, 0, 0, 0, 7};
+    // Same board with cars 2-7 numbered differently
+    renumbered_board =
+        std::vector<int>{0, 0, 0, 9, 9, 9, 0, 0, 2, 0, 5, 0, 1, 1, 2, 0, 5, 0,
+                         3, 3, 2, 0, 0, 4, 0, 8, 8, 8, 0, 4, 0, 0, 0, 0, 0, 4};
+  }
+
+  std::vector<int> game_board{};
+  std::vector<int> renumbered_board{};
+};
+
+TEST_F(SymmetryTest, RelabelsCarsByPosition) {
+  auto canonical = Symmetry::canonicalize(Board{game_board});
+  auto renumbered = Symmetry::canonicalize(Board{renumbered_board});
+
+  ASSERT_TRUE(canonical.board == renumbered.board);
+  ASSERT_FALSE(canonical.mirrored);
+  ASSERT_EQ(canonical.board.getGameBoardAt(0, 3), 2);
+  ASSERT_EQ(canonical.board.getGameBoardAt(2, 0), 1);
+  ASSERT_EQ(renumbered.to_canonical.at(9), 2);
+  ASSERT_EQ(renumbered.to_original.at(2), 9);
+}
+
+TEST_F(SymmetryTest, FoldsMirroredBoards) {
+  const Board board{game_board};
+  const auto mirrored = Symmetry::mirror(board);
+
+  ASSERT_EQ(mirrored.getGameBoardAt(5, 3), 3);
+  ASSERT_EQ(mirrored.getMainCar(), Car(1, 3, 0, 2, Car::Direction::Horizontal));
+  ASSERT_FALSE(Symmetry::canonicalize(board).board ==
+               Symmetry::canonicalize(mirrored).board);
+  ASSERT_TRUE(Symmetry::canonicalize(board, true).board ==
+              Symmetry::canonicalize(mirrored, true).board);
+}
+
+TEST_F(SymmetryTest, MapsMovesBetweenBoards) {
+  const Board board{renumbered_board};
+  const std::vector<Move> moves{{9, -1}, {5, 1}, {4, -1}};
+  auto canonical = Symmetry::canonicalize(board, true);
+
+  auto canonical_moves = Symmetry::toCanonical(canonical, moves);
+  ASSERT_EQ(Symmetry::toOriginal(canonical, canonical_moves), moves);
+
+  auto original_end = board;
+  auto canonical_end = canonical.board;
+  for (std::size_t i = 0; i < moves.size(); ++i) {
+    original_end = original_end.applyMove(moves[i]);
+    canonical_end = canonical_end.applyMove(canonical_moves[i]);
+  }
+  if (canonical.mirrored) {
+    original_end = Symmetry::mirror(original_end);
+  }
+  for (auto i = 0; i < 6; ++i) {
+    for (auto j = 0; j < 6; ++j) {
+      auto id = original_end.getGameBoardAt(i, j);
+      ASSERT_EQ(canonical_end.getGameBoardAt(i, j),
+                id == 0 ? 0 : canonical.to_canonical.at(id));
+    }
+  }
+}
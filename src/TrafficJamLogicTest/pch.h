@@ -1,8 +1,8 @@
-//
-// pch.h
-// Header for standard system include files.
-//
-
-#pragma once
-
-#include "gtest/gtest.h"
+//
+// pch.h
+// Header for standard system include files.
+//
+
+#pragma once
+
+#include "gtest/gtest.h"
@@ -0,0 +1,46 @@
+/**
+ * Copyright 2019 Martin Pham
+ */
+
+#include "../TrafficJamLogic/SolverServer.h"
+
+#include <signal.h>
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <socket> [workers]" << '\n';
+    return 1;
+  }
+
+  SolverServer::Options options{};
+  options.path = argv[1];
+  options.workers = argc > 2 ? std::stoul(argv[2]) : 0;
+
+  // Handle SIGINT and SIGTERM on a thread of their own, every other thread
+  // inherits the blocked mask
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  try {
+    SolverServer server{options};
+    std::thread{[&server, signals] {
+      int signal = 0;
+      sigwait(&signals, &signal);
+      server.stop();
+    }}.detach();
+
+    std::cout << "Listening on " << options.path << '\n';
+    server.run();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+}